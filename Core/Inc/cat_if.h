@@ -0,0 +1,80 @@
+/**
+  *******************************************************************************
+  *
+  * @file    cat_if.h
+  * @brief   Header for cat_if.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_CAT_IF_H_
+#define INC_CAT_IF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+void CAT_Buff_Write_Byte (uint8_t);
+uint32_t CAT_Buff_Free (void);
+void CAT_Init (void);
+void CAT_Handler (void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#define CAT_BUFF_SIZE                         256U  /* Power of 2 */
+#define CAT_CMD_SIZE                          64U
+#define CAT_REPLY_SIZE                        32U
+
+#define CAT_ID                                "020"  /* TS-480 */
+#define CAT_KY_TEXT_SIZE                      24U
+
+/* Remote keying frame: sync, type, 32 bit little endian value */
+#define CAT_KEY_SYNC                          0xA5U
+#define CAT_KEY_FRAME_SIZE                    6U
+#define CAT_KEY_UP                            0x00U  /* Value is time stamp, us */
+#define CAT_KEY_DOWN                          0x01U  /* Value is time stamp, us */
+#define CAT_KEY_DELAY                         0x02U  /* Value is playout delay, ms */
+#define CAT_KEY_EXPORT                        0x03U  /* Value is 1 - export events, 0 - stop */
+
+typedef struct
+{
+  uint8_t       buff [CAT_BUFF_SIZE];
+  __IO uint32_t wr_ptr;       /* Free running write index, ISR side */
+  __IO uint32_t rd_ptr;       /* Free running read index, main loop side */
+  uint32_t      overflows;    /* Bytes lost because the buffer was full */
+} CAT_Buff_TypeDef;
+
+typedef struct
+{
+  char name [3];
+  void (*handler) (char *param, uint32_t len);
+} CAT_Cmd_TypeDef;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_CAT_IF_H_ */
@@ -30,9 +30,34 @@ typedef struct CW_Keyer
 {
   uint8_t  mode;
   uint8_t  speed;
-  uint8_t  pitch;
+  uint16_t pitch;       /* Hz */
 } CW_Keyer;
 
+typedef struct CW_Route
+{
+  uint8_t  out [2];     /* Source of left and right channels */
+  int32_t  tx_level;    /* TX signal level, Q15 */
+  int32_t  st_level;    /* Sidetone level, Q15 */
+  int32_t  st_step;     /* Sidetone envelope step per sample, Q8 table entries */
+} CW_Route;
+
+typedef struct CW_IQ
+{
+  uint8_t  is_on;       /* TX signal is I/Q at IF offset */
+  uint8_t  swap;        /* I and Q are swapped */
+  int32_t  offset;      /* IF offset, Hz */
+  int32_t  q_cos;       /* Q correction: gain * cos (phase), Q14 */
+  int32_t  q_sin;       /* Q correction: gain * sin (phase), Q14 */
+} CW_IQ;
+
+typedef struct CW_Remote_Stats
+{
+  uint32_t events;      /* Remote key events received */
+  uint32_t late;        /* Events which came after their playout time */
+  uint32_t dropped;     /* Events lost because the jitter buffer was full */
+  uint32_t resyncs;     /* Playout timing has been taken again */
+} CW_Remote_Stats;
+
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
@@ -40,9 +65,31 @@ typedef struct CW_Keyer
 /* Exported functions prototypes ---------------------------------------------*/
 
 void CW_Set_Pitch (uint32_t, uint32_t);
+void CW_Init (void);
 void CW_Set_Keyer (void);
+void CW_Key_Off (void);
 void CW_Set_Speed (void);
-void CW_Handler   (int16_t*, int16_t*, uint16_t);
+void CW_Handler   (int16_t*, uint16_t);
+
+void CW_Set_Route (uint8_t, uint8_t);
+void CW_Set_TX_Level (int32_t);
+void CW_Set_TX_Delay (uint32_t);
+void CW_Set_Sidetone (int32_t, uint32_t);
+void CW_Set_IQ (uint8_t, int32_t, uint8_t);
+void CW_Set_IQ_Balance (int32_t, int32_t);
+
+uint16_t CW_Text_Write   (const char*, uint16_t);
+uint16_t CW_Text_Free    (void);
+uint8_t  CW_Text_Pending (void);
+void     CW_Text_Clear   (void);
+void     CW_Text_Backspace (void);
+void     CW_Text_Pause   (uint8_t);
+uint32_t CW_Text_Input_Ptr (void);
+uint8_t  CW_Text_Overwrite (uint32_t, char);
+void     CW_Text_Sent_Callback (char);
+
+void     CW_Remote_Key (uint8_t, uint32_t);
+void     CW_Remote_Set_Delay (uint32_t);
 
 /* Private defines -----------------------------------------------------------*/
 
@@ -51,4 +98,33 @@ void CW_Handler   (int16_t*, int16_t*, uint16_t);
 #define ULTIMATE            2
 #define STRAIGHT            3
 
+#define CW_PITCH_MIN        300   /* Hz */
+#define CW_PITCH_MAX        1000  /* Hz */
+#define CW_PITCH_DEFAULT    700   /* Hz */
+#define CW_PITCH_STEP       10    /* Encoder step, Hz */
+
+#define CW_TEXT_BUFF_SIZE   128   /* Power of 2 */
+
+#define CW_REMOTE_BUFF_SIZE 64    /* Power of 2 */
+#define CW_REMOTE_DELAY     50    /* Default playout delay, ms */
+#define CW_REMOTE_DELAY_MAX 1000  /* ms */
+#define CW_REMOTE_IDLE      1000  /* Key up time to take timing again, ms */
+#define CW_SAMPLES_PER_MS   48    /* USBD_AUDIO_FREQ / 1000 */
+#define CW_BLOCK_MAX        (CW_SAMPLES_PER_MS * 2)  /* Longest audio block, samples */
+#define CW_GAIN_MAX         32767 /* Gain 1.0 in Q15 */
+
+/* Channel sources */
+#define CW_ROUTE_SIDETONE   0     /* Sidetone mixed with RX audio */
+#define CW_ROUTE_TX_I       1     /* TX signal I or mono */
+#define CW_ROUTE_TX_Q       2     /* TX signal Q */
+#define CW_ROUTE_MUTE       3
+
+#define CW_TX_LEVEL         16384 /* Default TX signal level, Q15 */
+#define CW_ST_LEVEL         12288 /* Default sidetone level, Q15 */
+#define CW_ST_RISE          5     /* Default sidetone rise time, ms */
+#define CW_ST_RISE_MAX      5     /* TX signal rise time, ms */
+
+#define CW_IQ_OFFSET_MAX    23000 /* IF offset limit, Hz */
+#define CW_IQ_ONE           16384 /* Gain 1.0 in Q14 */
+
 #endif /* INC_CW_GEN_H_ */
@@ -30,13 +30,13 @@
 typedef struct
 {
   uint32_t ptr;   /* DDS pointer */
-  uint32_t step;  /* DDS step - not working if part of the structure */
+  __IO uint32_t step;  /* DDS step, written at once while DDS is running */
 } soft_dds_t;
 
 /* Exported constants --------------------------------------------------------*/
 
-#define DDS_TBL_BITS        10
-#define DDS_TBL_SIZE        (1 << DDS_TBL_BITS) /* 2^10 = 1024 */
+#define DDS_TBL_BITS        8
+#define DDS_TBL_SIZE        (1 << DDS_TBL_BITS) /* 2^8 = 256 points per quarter */
 
 /* Exported macro ------------------------------------------------------------*/
 
@@ -46,16 +46,21 @@ void DDS_Set_CW_Pitch  (uint32_t freq, uint32_t sample_rate);
 void DDS_CW_Monitor    (int16_t *buff0, int16_t *buff1, uint8_t scaling);
 void DDS_Get_Sample    (int16_t *buff);
 void DDS_Get_IQ_Sample (int16_t *i_buff, int16_t *q_buff);
+void DDS_Set_TX_Offset (int32_t freq, uint32_t sample_rate);
+void DDS_Get_TX_IQ_Sample (int16_t *i_buff, int16_t *q_buff);
+void DDS_Init          (void);
 
 
+int16_t softdds_sin (uint32_t phase);
+uint32_t softdds_getStep (uint32_t freq, uint32_t sample_rate);
 void softdds_setFreqDDS (soft_dds_t *dds, uint32_t freq, uint32_t sample_rate, uint8_t smooth);
 void softdds_genIQSingleTone (soft_dds_t *dds, int16_t *i_buff, int16_t *q_buff, uint16_t size);
-void softdds_genIQTwoTone (soft_dds_t *ddsA, soft_dds_t *ddsB, uint16_t *i_buff, uint16_t *q_buff, uint16_t size);
+void softdds_genIQTwoTone (soft_dds_t *ddsA, soft_dds_t *ddsB, int16_t *i_buff, int16_t *q_buff, uint16_t size);
 
 void softdds_addSingleTone (soft_dds_t *dds_ptr, int16_t *buff, uint8_t scaling);
 void softdds_addSingleToneToTwobuffers (soft_dds_t *dds_ptr, int16_t *buff0, int16_t *buff1, uint8_t scaling);
 
-void softdds_runIQ (uint16_t *i_buff, uint16_t *q_buff, uint16_t size);
+void softdds_runIQ (int16_t *i_buff, int16_t *q_buff, uint16_t size);
 void softdds_configRunIQ (uint32_t freq [2], uint32_t samp_rate, uint8_t smooth);
 
 /* Private defines -----------------------------------------------------------*/
@@ -45,6 +45,8 @@ void DSP_In_Buff_Read (uint8_t*, uint32_t);
 void DSP_Set_TX (void);
 void DSP_Set_RX (void);
 void DSP_Set_Mode (uint8_t);
+void DSP_Set_Delay (uint32_t);
+void DSP_Set_QSK (uint8_t);
 void DSP_Init (void);
 
 /* Private defines -----------------------------------------------------------*/
@@ -63,6 +65,25 @@ void DSP_Init (void);
 #define DSP_BUFF_SIZE            (uint16_t)((DSP_BUFF_PACKET_SIZE * DSP_BUFF_PACKET_NUM))  /* DSP buffer size in samples */
 #define DSP_BUFF_HALF_SIZE       (uint16_t)((DSP_BUFF_SIZE / 2U))                          /* DSP buffer half size */
 
+#define DSP_DELAY_SIZE           1024U  /* TX delay line size in samples, power of 2 */
+
+#define DSP_GAIN_MAX             32767  /* Gain 1.0 in Q15 */
+#define DSP_RX_RAMP_STEP         (DSP_GAIN_MAX / 240)  /* RX mute ramp of 5 ms */
+
+typedef struct
+{
+  int32_t gain;                 /* RX audio gain, Q15 */
+  int32_t target;               /* Gain the ramp goes to, Q15 */
+  uint8_t qsk;                  /* 1 - full break-in, 0 - RX is muted during TX */
+} DSP_RX_TypeDef;
+
+typedef struct
+{
+  int16_t  buff [2][DSP_DELAY_SIZE];
+  uint32_t wr_ptr;
+  uint32_t length;              /* Delay in samples, 0 - no delay */
+} DSP_Delay_TypeDef;
+
 typedef struct
 {
   int16_t  i [DSP_BUFF_SIZE];
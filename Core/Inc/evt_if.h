@@ -0,0 +1,83 @@
+/**
+  *******************************************************************************
+  *
+  * @file    evt_if.h
+  * @brief   Header for evt_if.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_EVT_IF_H_
+#define INC_EVT_IF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Record types, key records have the same types as remote keying frames */
+#define EVT_KEY_UP                            0x00U
+#define EVT_KEY_DOWN                          0x01U
+#define EVT_DIT_UP                            0x10U
+#define EVT_DIT_DOWN                          0x11U
+#define EVT_DAH_UP                            0x12U
+#define EVT_DAH_DOWN                          0x13U
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+void EVT_Put (uint8_t);
+void EVT_Put_Time (uint8_t, uint32_t);
+void EVT_Set_Export (uint8_t);
+void EVT_Init (void);
+void EVT_Handler (void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#define EVT_BUFF_SIZE                         64U   /* Power of 2 */
+#define EVT_SYNC                              0xA5U
+#define EVT_RECORD_SIZE                       6U    /* Sync, type, 32 bit us time stamp */
+#define EVT_BATCH                             10U   /* Records per batch, 60 bytes fit one USB packet */
+#define EVT_TIMEOUT                           20U   /* Max batching time, ms */
+
+typedef struct
+{
+  uint32_t time;          /* Time stamp, us */
+  uint8_t  type;
+} EVT_Record_TypeDef;
+
+typedef struct
+{
+  EVT_Record_TypeDef buff [EVT_BUFF_SIZE];
+  __IO uint32_t      wr_ptr;      /* Free running, interrupt side */
+  __IO uint32_t      rd_ptr;      /* Free running, main loop side */
+  __IO uint8_t       export;
+  uint8_t            batch_open;
+  uint32_t           batch_start; /* Time of the oldest record, us */
+  uint32_t           overflows;   /* Records lost and batches the CDC ring had no room for */
+} EVT_TypeDef;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_EVT_IF_H_ */
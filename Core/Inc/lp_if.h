@@ -0,0 +1,80 @@
+/**
+  *******************************************************************************
+  *
+  * @file    lp_if.h
+  * @brief   Header for lp_if.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_LP_IF_H_
+#define INC_LP_IF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Private defines -----------------------------------------------------------*/
+
+#define LP_WINDOW                             1000U   /* Idle ratio window, ms */
+#define LP_LINE_SIZE                          96U
+
+/* Supply current of the board in run and in sleep, uA. The defaults are
+ * rough STM32F411 figures at 96 MHz, the ZL current is estimated from
+ * them and is only as good as they are: set them to the values measured
+ * with a meter */
+#define LP_RUN_CURRENT                        20000U
+#define LP_SLEEP_CURRENT                      7000U
+
+typedef struct
+{
+  __IO uint8_t suspended; /* USB bus is suspended */
+
+  uint32_t window_start;  /* us */
+  uint32_t idle_run;      /* Sleep in the current window, us */
+  uint32_t idle;          /* Sleep in the last window, 0.1% */
+  uint32_t current_est;   /* Supply current estimate of the last window, uA */
+
+  uint32_t suspends;      /* USB suspends */
+  uint32_t stops;         /* STOP mode entries */
+  uint32_t resume;        /* Clock restore time of the last STOP exit, us */
+  uint32_t resume_max;    /* Since reset, us */
+} LP_TypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+extern LP_TypeDef lp;
+
+void LP_Init (void);
+void LP_Sleep (void);
+void LP_Suspend (void);
+void LP_Resume (void);
+void LP_Reset (void);
+uint32_t LP_Format (char*, uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_LP_IF_H_ */
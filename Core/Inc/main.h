@@ -41,8 +41,7 @@ extern "C" {
 typedef struct
 {
   uint8_t  is_tx;
-  uint32_t sysclock;
-  uint8_t  systicks;
+  uint8_t  mode;
 } TRX_TypeDef;
 
 /* USER CODE END ET */
@@ -55,8 +54,30 @@ typedef struct
 /* Exported macro ------------------------------------------------------------*/
 /* USER CODE BEGIN EM */
 
+/* Audio hot path code and tables run from RAM without flash wait states,
+ * see section .hot in STM32F411CEUX_FLASH.ld. -DHOT_RAM=0 leaves them in
+ * flash to compare the profiler zones of both builds.
+ * PendSV rendering and the keyer edge path (SEQ, EVT, PTT, CDC ring) stay
+ * in RAM. Still in flash, reached through long call veneers: the ST USB
+ * middleware and HAL, i.e. USBD_LL_Transmit and HAL_PCD_EP_Transmit once
+ * per full CDC echo packet, and HAL_PCD_IRQHandler which calls the audio
+ * class callbacks. Host/Tools/hot_report.sh reports .hot after the build */
+#ifndef HOT_RAM
+#define HOT_RAM                               1
+#endif
+
+#if HOT_RAM
+#define __HOT_FUNC                            __attribute__((section (".hot_text")))
+#define __HOT_DATA                            __attribute__((section (".hot_rodata")))
+#else
+#define __HOT_FUNC
+#define __HOT_DATA
+#endif
+
 /* USER CODE END EM */
 
+void HAL_TIM_MspPostInit(TIM_HandleTypeDef *htim);
+
 /* Exported functions prototypes ---------------------------------------------*/
 void Error_Handler(void);
 
@@ -67,6 +88,12 @@ void Error_Handler(void);
 /* Private defines -----------------------------------------------------------*/
 #define TX_Pin GPIO_PIN_13
 #define TX_GPIO_Port GPIOC
+#define KEY_OUT_Pin GPIO_PIN_0
+#define KEY_OUT_GPIO_Port GPIOA
+#define AMP_PTT_Pin GPIO_PIN_1
+#define AMP_PTT_GPIO_Port GPIOA
+#define RELAY_PTT_Pin GPIO_PIN_2
+#define RELAY_PTT_GPIO_Port GPIOA
 #define KEY_DIT_Pin GPIO_PIN_0
 #define KEY_DIT_GPIO_Port GPIOB
 #define KEY_DIT_EXTI_IRQn EXTI0_IRQn
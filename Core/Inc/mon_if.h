@@ -0,0 +1,205 @@
+/**
+  *******************************************************************************
+  *
+  * @file    mon_if.h
+  * @brief   Header for mon_if.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_MON_IF_H_
+#define INC_MON_IF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Monitored interrupt handlers */
+#define MON_USB                               0U    /* OTG_FS_IRQHandler */
+#define MON_EXTI                              1U    /* Paddle EXTI handlers */
+#define MON_TIM                               2U    /* TIM2_IRQHandler */
+#define MON_ADC                               3U    /* ADC_IRQHandler */
+#define MON_TICK                              4U    /* SysTick_Handler */
+#define MON_RENDER                            5U    /* PendSV_Handler, audio render */
+#define MON_ISR_NUM                           6U
+
+/* Alarm bits, latched until MON_Reset () */
+#define MON_ALARM_LOAD                        0x01U /* Interrupt load is over MON_LOAD_LIMIT */
+#define MON_ALARM_LATENCY                     0x02U /* Interrupt entry is later than MON_LATENCY_LIMIT */
+#define MON_ALARM_ISR                         0x04U /* A handler has run longer than MON_ISR_LIMIT */
+#define MON_ALARM_OVERRUN                     0x08U /* An audio packet was sent before it was rendered */
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* A handler is timed between MON_ISR_ENTER and MON_ISR_EXIT in the same block */
+#define MON_ISR_ENTER()                       uint32_t mon_enter = MON_ISR_Enter ()
+#define MON_ISR_EXIT(isr)                     MON_ISR_Exit (isr, mon_enter)
+
+/* Private defines -----------------------------------------------------------*/
+
+#define MON_WINDOW                            100U  /* Load window, SysTick periods (ms) */
+#define MON_LINE_SIZE                         192U
+
+/* Budgets against the 1 ms audio frame, in frames / 256 */
+#define MON_LOAD_LIMIT                        179U  /* 70% of cycles in interrupt handlers */
+#define MON_LATENCY_LIMIT                     64U   /* 250 us interrupt entry latency */
+#define MON_ISR_LIMIT                         128U  /* 500 us in one handler run */
+#define MON_RENDER_LIMIT                      230U  /* 900 us in one audio render */
+
+typedef struct
+{
+  uint32_t max;           /* Longest run since reset, cycles */
+  uint32_t window_max;    /* Longest run in the last window, cycles */
+  uint32_t run_max;       /* Longest run in the current window, cycles */
+  uint32_t count;
+} MON_ISR_TypeDef;
+
+typedef struct
+{
+  MON_ISR_TypeDef isr [MON_ISR_NUM];
+  uint32_t depth;         /* Nested handlers */
+  uint32_t busy_start;    /* Entry of the outermost handler, cycles */
+  uint32_t busy;          /* Cycles in handlers in the current window */
+  uint32_t ticks;         /* SysTick periods in the current window */
+  uint32_t frame;         /* Cycles per SysTick period */
+
+  uint32_t latency;       /* SysTick entry latency in the last window, cycles */
+  uint32_t latency_run;   /* SysTick entry latency in the current window, cycles */
+  uint32_t latency_max;   /* Since reset, cycles */
+
+  uint32_t load;          /* Interrupt load in the last window, 0.1% */
+  uint32_t load_max;      /* Since reset, 0.1% */
+
+  uint32_t loop_start;    /* Main loop pass start, cycles */
+  uint32_t loop_run;      /* Longest main loop pass in the current window, cycles */
+  uint32_t loop;          /* Longest main loop pass in the last window, cycles */
+  uint32_t loops_run;     /* Main loop passes in the current window */
+  uint32_t loops;         /* Main loop passes in the last window */
+
+  uint32_t overruns;      /* Audio render overruns since reset */
+
+  __IO uint32_t alarm;    /* MON_ALARM_xxx */
+  uint32_t alarms;        /* Windows with an alarm */
+} MON_TypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+extern MON_TypeDef mon;
+
+void MON_Init (void);
+void MON_Reset (void);
+void MON_Tick (void);
+void MON_Loop (void);
+uint32_t MON_Format (char*, uint32_t);
+
+/**
+ * @brief This function marks an interrupt handler entry
+ *
+ * The nesting is counted with interrupts masked, a handler preempting
+ * the update would be counted twice in the interrupt load
+ *
+ * @retval Entry time, cycles
+ */
+
+__STATIC_INLINE uint32_t MON_ISR_Enter (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint32_t now;
+
+  __disable_irq ();
+
+  now = DWT->CYCCNT;
+
+  if (mon.depth++ == 0U)
+  {
+    mon.busy_start = now;
+  }
+
+  __set_PRIMASK (primask);
+
+  return now;
+}
+
+/**
+ * @brief This function marks an interrupt handler exit
+ *
+ * A nested handler is counted in its own time and in the time of the
+ * handler it has preempted, but only once in the interrupt load
+ *
+ * @param Handler, MON_xxx
+ * @param Entry time, cycles
+ */
+
+__STATIC_INLINE void MON_ISR_Exit (uint32_t isr, uint32_t enter)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint32_t now;
+  uint32_t cycles;
+  MON_ISR_TypeDef *s = &mon.isr [isr];
+
+  __disable_irq ();
+
+  now = DWT->CYCCNT;
+
+  if (--mon.depth == 0U)
+  {
+    mon.busy += now - mon.busy_start;
+  }
+
+  __set_PRIMASK (primask);
+
+  /* A handler does not preempt itself, its own statistics need no masking */
+  cycles = now - enter;
+
+  s->count++;
+
+  if (cycles > s->run_max) s->run_max = cycles;
+}
+
+/**
+ * @brief This function marks the main loop wake up
+ *
+ * The sleep is left out of the main loop pass
+ */
+
+__STATIC_INLINE void MON_Wake (void)
+{
+  mon.loop_start = DWT->CYCCNT;
+}
+
+/**
+ * @brief This function marks an audio render overrun
+ *
+ * The alarm is raised at once, it does not wait for the window end
+ */
+
+__STATIC_INLINE void MON_Overrun (void)
+{
+  mon.overruns++;
+  mon.alarm |= MON_ALARM_OVERRUN;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MON_IF_H_ */
@@ -0,0 +1,133 @@
+/**
+  *******************************************************************************
+  *
+  * @file    prof_if.h
+  * @brief   Header for prof_if.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_PROF_IF_H_
+#define INC_PROF_IF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* The profiler is built into Debug configuration only, -DPROF_ENABLE=0/1 overrides it */
+#ifndef PROF_ENABLE
+#ifdef DEBUG
+#define PROF_ENABLE                           1
+#else
+#define PROF_ENABLE                           0
+#endif
+#endif
+
+/* Zones, the inner zones are included in the outer ones */
+#define PROF_USB_ISR                          0U    /* OTG_FS_IRQHandler */
+#define PROF_MIX                              1U    /* DSP_In_Buff_Read, CW render included */
+#define PROF_CW                               2U    /* CW_Handler */
+#define PROF_EXTI                             3U    /* Paddle EXTI handlers */
+#define PROF_UI                               4U    /* UI_Handler, display update included */
+#define PROF_DISPLAY                          5U    /* ssd1306_UpdateScreen */
+#define PROF_ZONES                            6U
+
+/* Exported macro ------------------------------------------------------------*/
+
+#if PROF_ENABLE
+
+/* A zone is timed between PROF_START and PROF_STOP in the same block */
+#define PROF_START(zone)                      uint32_t prof_start_##zone = DWT->CYCCNT
+#define PROF_STOP(zone)                       PROF_Add (zone, DWT->CYCCNT - prof_start_##zone)
+
+#else
+
+#define PROF_START(zone)
+#define PROF_STOP(zone)
+#define PROF_Init()
+
+#endif
+
+/* Private defines -----------------------------------------------------------*/
+
+#define PROF_HIST_BINS                        16U   /* Bin n > 0 holds 2^(n+5)...2^(n+6)-1 cycles */
+#define PROF_HIST_SHIFT                       6U    /* Bin 0 holds 0...63 cycles */
+#define PROF_LINE_SIZE                        256U
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t min;           /* Cycles */
+  uint32_t max;           /* Cycles */
+  uint64_t sum;           /* Cycles */
+  uint32_t hist [PROF_HIST_BINS];
+} PROF_Zone_TypeDef;
+
+typedef struct
+{
+  PROF_Zone_TypeDef zone [PROF_ZONES];
+} PROF_TypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+#if PROF_ENABLE
+
+extern PROF_TypeDef prof;
+
+void PROF_Init (void);
+void PROF_Reset (void);
+uint32_t PROF_Format (uint8_t, char*, uint32_t);
+
+/**
+ * @brief This function adds a zone run time
+ *
+ * A zone is updated by one interrupt priority or by the main loop only
+ *
+ * @param Zone
+ * @param Cycles
+ */
+
+__STATIC_INLINE void PROF_Add (uint32_t zone, uint32_t cycles)
+{
+  PROF_Zone_TypeDef *z = &prof.zone [zone];
+  uint32_t bin = 32U - __CLZ (cycles >> PROF_HIST_SHIFT);
+
+  if (bin >= PROF_HIST_BINS)
+  {
+    bin = PROF_HIST_BINS - 1U;
+  }
+
+  z->count++;
+  z->sum += cycles;
+  z->hist [bin]++;
+
+  if (cycles < z->min) z->min = cycles;
+  if (cycles > z->max) z->max = cycles;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_PROF_IF_H_ */
@@ -35,9 +35,23 @@ typedef struct
   uint8_t  rts_is_on;
   uint8_t  key_dah_is_on;
   uint8_t  key_dit_is_on;
-  uint32_t key_off_time;
+  uint8_t  cat_is_on;
+  uint8_t  tune_is_on;
+  uint8_t  key_off_is_on;
+  uint8_t  key_bounce;    /* Paddles with an edge ignored in the lockout, PTT_DAH/PTT_DIT bits */
+  uint32_t key_dah_time;  /* Last accepted DAH paddle edge, us */
+  uint32_t key_dit_time;  /* Last accepted DIT paddle edge, us */
+  uint32_t key_off_time;  /* us */
+  uint32_t hang_time;     /* ms */
 } PTT_TypeDef;
 
+typedef struct
+{
+  uint32_t tune [2];  /* VFO A and VFO B frequency in Hz */
+  uint8_t  active;    /* 0 - VFO A, 1 - VFO B */
+  uint8_t  split;
+} VFO_TypeDef;
+
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
@@ -48,22 +62,34 @@ void PTT_Init (void);
 void PTT_Handler (void);
 
 void PTT_Set_Mode (uint8_t);
+void PTT_Force_RX (void);
 void PTT_CAT_TX (uint8_t);
 void PTT_DTR_TX (uint8_t);
 void PTT_RTS_TX (uint8_t);
+void PTT_Tune_TX (uint8_t);
+void PTT_Key_On (void);
 void PTT_Key_Off_Time (void);
+void PTT_Set_Hang_Time (uint32_t);
 
 void VFO_Toggle_VFO (void);
 void VFO_Set_Tune (uint32_t);
+void VFO_Set_VFO_Tune (uint8_t, uint32_t);
 void VFO_Set_Tune_BCD (uint32_t);
-void VFO_Set_Tune_UI (uint32_t);
 uint32_t VFO_Get_Tune (void);
+uint32_t VFO_Get_VFO_Tune (uint8_t);
 uint32_t VFO_Get_Tune_BCD (void);
 void VFO_Set_Split (uint8_t);
 
 /* Private defines -----------------------------------------------------------*/
 
-#define KEY_TIMEOUT                           25 // 250 ms
+#define PTT_HANG_TIME                         250U // ms
+#define PTT_DEBOUNCE_TIME                     3U   // Paddle edge lockout, ms
+
+#define PTT_DAH                               0x01U
+#define PTT_DIT                               0x02U
+
+#define TRX_MODE_CW                           3U // Kenwood mode numbering
+#define VFO_DEFAULT_TUNE                      14025000U
 
 #ifdef __cplusplus
 }
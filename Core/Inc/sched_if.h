@@ -0,0 +1,82 @@
+/**
+  *******************************************************************************
+  *
+  * @file    sched_if.h
+  * @brief   Header for sched_if.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_SCHED_IF_H_
+#define INC_SCHED_IF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*SCHED_Handler) (void);
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Tasks in priority order, a lower number runs first */
+#define SCHED_PTT                             0U    /* PTT hang time */
+#define SCHED_CAT                             1U    /* CAT and WinKeyer parser, on CDC data */
+#define SCHED_CDC                             2U    /* CDC transmit flush and receive resume */
+#define SCHED_WK                              3U    /* WinKeyer status */
+#define SCHED_EVT                             4U    /* Key event export */
+#define SCHED_UI                              5U    /* Display and controls */
+#define SCHED_TASKS                           6U
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Private defines -----------------------------------------------------------*/
+
+#define SCHED_LINE_SIZE                       96U
+
+typedef struct
+{
+  const char    *name;
+  SCHED_Handler handler;
+  uint32_t      period;       /* us, 0 - run on SCHED_Post () only */
+  uint32_t      deadline;     /* us from release to completion */
+  uint32_t      release;      /* Next periodic release, us */
+  __IO uint8_t  posted;       /* SCHED_Post () is pending */
+  __IO uint32_t post_time;    /* Time of the first pending post, us */
+
+  uint32_t      runs;
+  uint32_t      overruns;     /* Runs completed after the deadline */
+  uint32_t      jitter_max;   /* Longest release to start, us */
+  uint32_t      run_max;      /* Longest run, us */
+} SCHED_Task_TypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+void SCHED_Add (uint8_t, const char*, SCHED_Handler, uint32_t, uint32_t);
+void SCHED_Post (uint8_t);
+void SCHED_Run (void);
+void SCHED_Reset (void);
+uint32_t SCHED_Format (uint8_t, char*, uint32_t);
+void SCHED_Init (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_SCHED_IF_H_ */
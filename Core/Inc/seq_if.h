@@ -0,0 +1,97 @@
+/**
+  *******************************************************************************
+  *
+  * @file    seq_if.h
+  * @brief   Header for seq_if.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_SEQ_IF_H_
+#define INC_SEQ_IF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Outputs, the number is TIM2 channel - 1 */
+#define SEQ_KEY                               0U    /* TIM2_CH1, PA0 */
+#define SEQ_AMP                               1U    /* TIM2_CH2, PA1 */
+#define SEQ_RELAY                             2U    /* TIM2_CH3, PA2 */
+#define SEQ_OUT_NUM                           3U
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+void SEQ_Init (void);
+void SEQ_Key (uint8_t, uint32_t);
+void SEQ_PTT (uint8_t);
+void SEQ_Idle (void);
+uint8_t SEQ_Set_Timing (uint8_t, uint32_t, uint32_t);
+uint32_t SEQ_Get_Lead_Max (void);
+uint32_t SEQ_Get_Delay (void);
+uint8_t SEQ_Get_Audio_Delay (void);
+uint32_t SEQ_Format (uint8_t, char*, uint32_t);
+void SEQ_Set_Audio_Delay (uint8_t);
+
+/* Private defines -----------------------------------------------------------*/
+
+#define SEQ_QUEUE_SIZE                        8U    /* Power of 2 */
+#define SEQ_MARGIN                            2U    /* Min time to arm a compare, us */
+#define SEQ_LINE_SIZE                         32U
+
+#define SEQ_AMP_LEAD                          5000U   /* us */
+#define SEQ_AMP_TAIL                          5000U   /* us */
+#define SEQ_RELAY_LEAD                        10000U  /* us */
+#define SEQ_RELAY_TAIL                        20000U  /* us */
+
+typedef struct
+{
+  uint32_t time;          /* TIM2 time, us */
+  uint8_t  on;
+} SEQ_Event_TypeDef;
+
+typedef struct
+{
+  SEQ_Event_TypeDef queue [SEQ_QUEUE_SIZE];
+  uint32_t wr_ptr;
+  uint32_t rd_ptr;        /* The event at rd_ptr is armed in the timer */
+  uint8_t  on;            /* Output state after the last queued event */
+  uint32_t lead;          /* us */
+  uint32_t tail;          /* us */
+} SEQ_Output_TypeDef;
+
+typedef struct
+{
+  SEQ_Output_TypeDef out [SEQ_OUT_NUM];
+  uint8_t  audio_delay;   /* TX audio is delayed by the longest lead */
+  uint32_t delay;         /* Key out and TX audio delay, us */
+  uint32_t key_off_time;  /* Time of the last key out release, us */
+  uint32_t overflows;
+} SEQ_TypeDef;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_SEQ_IF_H_ */
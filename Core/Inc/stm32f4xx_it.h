@@ -59,8 +59,10 @@ void SysTick_Handler(void);
 void EXTI0_IRQHandler(void);
 void EXTI1_IRQHandler(void);
 void ADC_IRQHandler(void);
+void TIM2_IRQHandler(void);
 void OTG_FS_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void OTG_FS_WKUP_IRQHandler(void);
 
 /* USER CODE END EFP */
 
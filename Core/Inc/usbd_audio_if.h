@@ -63,6 +63,16 @@
 
 /* USER CODE BEGIN EXPORTED_TYPES */
 
+/* The next USB In packet is rendered in PendSV, one packet ahead */
+typedef struct
+{
+  uint8_t       *buff;          /* Half of USB In buffer to render */
+  uint32_t      size;           /* Bytes to render */
+  uint32_t      request;        /* Render requests counter */
+  uint32_t      overruns;       /* Packets sent before they were rendered */
+  __IO uint8_t  busy;           /* The last request is not rendered yet */
+} AUDIO_Render_TypeDef;
+
 /* USER CODE END EXPORTED_TYPES */
 
 /**
@@ -92,6 +102,8 @@ extern USBD_AUDIO_ItfTypeDef USBD_AUDIO_fops_FS;
 
 /* USER CODE BEGIN EXPORTED_VARIABLES */
 
+extern AUDIO_Render_TypeDef audio_render;
+
 /* USER CODE END EXPORTED_VARIABLES */
 
 /**
@@ -117,6 +129,8 @@ void HalfTransfer_CallBack_FS(void);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
 
+void AUDIO_Render_FS (void);
+
 /* USER CODE END EXPORTED_FUNCTIONS */
 
 /**
@@ -42,11 +42,10 @@ typedef struct
 typedef struct
 {
   USBD_ClassTypeDef *class;
-  void *classData;
-  void *userData;
-  uint16_t ctrlIf;
-  uint16_t minIf;
-  uint16_t maxIf;
+  uint8_t minIf;      /* First interface owned by the class */
+  uint8_t maxIf;      /* Last interface owned by the class */
+  uint8_t inEp;       /* Data IN endpoint address */
+  uint8_t outEp;      /* Data OUT endpoint address */
 } USBD_ClassCompInfo;
 
 
@@ -60,11 +59,11 @@ extern USBD_COMP_ItfTypeDef USBD_COMP_fops_FS;
 
 /* Exported functions prototypes ---------------------------------------------*/
 uint8_t USBD_COMP_RegisterInterface (USBD_HandleTypeDef *pdev, USBD_COMP_ItfTypeDef *fops);
-uint8_t COMP_CDC_Transmit_FS (uint8_t* Buf, uint16_t  Len);
 
 
 /* Private defines -----------------------------------------------------------*/
 #define CLASS_NUM                    2U
+#define COMP_NO_CLASS                0xFFU
 #define VCP                          0U
 #define UAC                          1U
 #define USBD_COMP_CLASS              &USBD_COMP
@@ -39,5 +39,7 @@ void UI_Handler (void);
 
 /* Private defines -----------------------------------------------------------*/
 
+#define UI_REDRAW_TIME                        250U // ms
+
 
 #endif /* INC_USER_IF_H_ */
@@ -0,0 +1,127 @@
+/**
+  *******************************************************************************
+  *
+  * @file    wk_if.h
+  * @brief   Header for wk_if.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_WK_IF_H_
+#define INC_WK_IF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+uint8_t WK_Is_Active (void);
+void WK_Parse_Byte (uint8_t);
+void WK_Init (void);
+void WK_Handler (void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#define WK_VERSION                            23U   /* WK2 firmware revision */
+#define WK_ARGS_SIZE                          15U   /* Load defaults */
+#define WK_EEPROM_SIZE                        256U
+
+/* Host commands */
+#define WK_ADMIN                              0x00U
+#define WK_SIDETONE                           0x01U
+#define WK_SPEED                              0x02U
+#define WK_POT_SETUP                          0x05U
+#define WK_PAUSE                              0x06U
+#define WK_GET_POT                            0x07U
+#define WK_BACKSPACE                          0x08U
+#define WK_CLEAR_BUFF                         0x0AU
+#define WK_KEY_IMMEDIATE                      0x0BU
+#define WK_MODE                               0x0EU
+#define WK_LOAD_DEFAULTS                      0x0FU
+#define WK_GET_STATUS                         0x15U
+#define WK_POINTER                            0x16U
+#define WK_PTT                                0x18U
+#define WK_MERGE                              0x1BU
+
+/* Admin commands */
+#define WK_ADMIN_RESET                        0x01U
+#define WK_ADMIN_OPEN                         0x02U
+#define WK_ADMIN_CLOSE                        0x03U
+#define WK_ADMIN_ECHO                         0x04U
+#define WK_ADMIN_GET_VALUES                   0x07U
+#define WK_ADMIN_GET_VERSION                  0x09U
+#define WK_ADMIN_LOAD_EEPROM                  0x0DU
+
+/* Pointer commands */
+#define WK_POINTER_RESET                      0x00U
+#define WK_POINTER_OVERWRITE                  0x01U
+#define WK_POINTER_APPEND                     0x02U
+#define WK_POINTER_NULLS                      0x03U
+
+/* Default values */
+#define WK_VAL_MODE                           0U
+#define WK_VAL_SPEED                          1U
+#define WK_VAL_SIDETONE                       2U
+#define WK_VAL_POT_MIN                        6U
+#define WK_VAL_POT_RANGE                      7U
+
+/* Mode register */
+#define WK_MODE_KEYER_MASK                    0x30U
+#define WK_MODE_SERIAL_ECHO                   0x04U
+
+/* Status byte */
+#define WK_STATUS                             0xC0U
+#define WK_STATUS_BUSY                        0x04U
+#define WK_STATUS_BREAKIN                     0x02U
+#define WK_STATUS_XOFF                        0x01U
+#define WK_SPEED_POT                          0x80U
+
+#define WK_XOFF_FREE                          (CW_TEXT_BUFF_SIZE / 3U)
+#define WK_SIDETONE_CLOCK                     62500U
+
+typedef struct
+{
+  uint8_t  is_open;
+  uint8_t  values [WK_ARGS_SIZE];  /* Defaults as loaded by the host */
+  uint8_t  status;        /* Last status byte sent to the host */
+  uint8_t  speed;         /* Last keyer speed reported to the host */
+
+  uint8_t  cmd;           /* Command waiting for arguments */
+  uint8_t  admin;         /* Command is an admin command */
+  uint8_t  args [WK_ARGS_SIZE];
+  uint32_t args_len;
+  uint32_t args_need;
+  uint32_t skip;          /* Bytes to ignore, e.g. EEPROM image */
+
+  uint8_t  overwrite;     /* Buffer pointer mode */
+  uint32_t base;          /* CW encoder position of buffer pointer 0 */
+  uint32_t in_ptr;        /* CW encoder position for overwrite mode */
+} WK_TypeDef;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_WK_IF_H_ */
@@ -0,0 +1,798 @@
+/**
+  *******************************************************************************
+  *
+  * @file    cat_if.c
+  * @brief   CAT Interface
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "cat_if.h"
+#include "usbd_cdc_if.h"
+#include "ptt_if.h"
+#include "cw_gen.h"
+#include "wk_if.h"
+#include "evt_if.h"
+#include "prof_if.h"
+#include "mon_if.h"
+#include "sched_if.h"
+#include "lp_if.h"
+#include "seq_if.h"
+
+#include <stdio.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+CAT_Buff_TypeDef cat_buff;
+
+char     cat_cmd [CAT_CMD_SIZE];
+uint32_t cat_cmd_len;
+uint8_t  cat_cmd_overflow;
+
+uint8_t  cat_key_frame [CAT_KEY_FRAME_SIZE];
+uint32_t cat_key_len;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void cat_cmd_fa (char*, uint32_t);
+static void cat_cmd_fb (char*, uint32_t);
+static void cat_cmd_fr (char*, uint32_t);
+static void cat_cmd_ft (char*, uint32_t);
+static void cat_cmd_id (char*, uint32_t);
+static void cat_cmd_ks (char*, uint32_t);
+static void cat_cmd_ky (char*, uint32_t);
+static void cat_cmd_md (char*, uint32_t);
+static void cat_cmd_rx (char*, uint32_t);
+static void cat_cmd_tx (char*, uint32_t);
+static void cat_cmd_zl (char*, uint32_t);
+static void cat_cmd_zm (char*, uint32_t);
+#if PROF_ENABLE
+static void cat_cmd_zp (char*, uint32_t);
+#endif
+static void cat_cmd_zq (char*, uint32_t);
+static void cat_cmd_zs (char*, uint32_t);
+
+/* Kenwood command table, sorted by name */
+
+static const CAT_Cmd_TypeDef cat_cmd_table [] =
+{
+  { "FA", cat_cmd_fa },
+  { "FB", cat_cmd_fb },
+  { "FR", cat_cmd_fr },
+  { "FT", cat_cmd_ft },
+  { "ID", cat_cmd_id },
+  { "KS", cat_cmd_ks },
+  { "KY", cat_cmd_ky },
+  { "MD", cat_cmd_md },
+  { "RX", cat_cmd_rx },
+  { "TX", cat_cmd_tx },
+  { "ZL", cat_cmd_zl },  /* Extension */
+  { "ZM", cat_cmd_zm },  /* Extension */
+#if PROF_ENABLE
+  { "ZP", cat_cmd_zp },  /* Extension */
+#endif
+  { "ZQ", cat_cmd_zq },  /* Extension */
+  { "ZS", cat_cmd_zs },  /* Extension */
+};
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+extern TRX_TypeDef trx;
+extern VFO_TypeDef vfo;
+extern CW_Keyer    cw_keyer;
+
+/* Audio hot path in RAM, see STM32F411CEUX_FLASH.ld */
+extern uint8_t _shot;
+extern uint8_t _ehot;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function sends CAT answer
+ *
+ * @param Answer string with terminator
+ */
+
+static void cat_reply (const char *str)
+{
+  uint16_t len = 0U;
+
+  while (str [len] != '\0')
+  {
+    len++;
+  }
+
+  CDC_Write_FS ((const uint8_t*) str, len);
+}
+
+/**
+ * @brief This function sends CAT error answer
+ *
+ */
+
+static void cat_error (void)
+{
+  cat_reply ("?;");
+}
+
+/**
+ * @brief This function converts decimal CAT parameter
+ *
+ * @param Parameter string
+ * @param Parameter length
+ * @param Pointer to result
+ * @retval 1 if the parameter is a valid number
+ */
+
+static uint8_t cat_get_number (const char *param, uint32_t len, uint32_t *value)
+{
+  uint32_t result = 0U;
+
+  if (len == 0U) return 0U;
+
+  for (uint32_t i = 0U; i < len; i++)
+  {
+    if ((param [i] < '0') || (param [i] > '9')) return 0U;
+
+    result = result * 10U + (uint32_t) (param [i] - '0');
+  }
+
+  *value = result;
+
+  return 1U;
+}
+
+/**
+ * @brief This function converts comma separated decimal CAT parameters
+ *
+ * @param Parameter string
+ * @param Parameter length
+ * @param Pointer to results
+ * @param Number of values
+ * @retval 1 if the parameter is exactly this number of valid numbers
+ */
+
+static uint8_t cat_get_numbers (const char *param, uint32_t len, uint32_t *value, uint32_t count)
+{
+  uint32_t start = 0U;
+  uint32_t n     = 0U;
+
+  for (uint32_t i = 0U; i <= len; i++)
+  {
+    if ((i < len) && (param [i] != ',')) continue;
+
+    if ((n >= count) || !cat_get_number (param + start, i - start, &value [n])) return 0U;
+
+    n++;
+    start = i + 1U;
+  }
+
+  return n == count;
+}
+
+/**
+ * @brief This function reads or sets VFO frequency
+ *
+ * FA; - read, FA00014025000; - set 11 digits in Hz
+ *
+ * @param Command name
+ * @param VFO number
+ * @param Parameter string
+ * @param Parameter length
+ */
+
+static void cat_vfo_tune (const char *name, uint8_t n, char *param, uint32_t len)
+{
+  char     reply [CAT_REPLY_SIZE];
+  uint32_t tune;
+
+  if (len == 0U)
+  {
+    sprintf (reply, "%s%011lu;", name, (unsigned long) VFO_Get_VFO_Tune (n));
+    cat_reply (reply);
+  }
+  else if ((len == 11U) && cat_get_number (param, len, &tune))
+  {
+    VFO_Set_VFO_Tune (n, tune);
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief FA - VFO A frequency
+ *
+ */
+
+static void cat_cmd_fa (char *param, uint32_t len)
+{
+  cat_vfo_tune ("FA", 0U, param, len);
+}
+
+/**
+ * @brief FB - VFO B frequency
+ *
+ */
+
+static void cat_cmd_fb (char *param, uint32_t len)
+{
+  cat_vfo_tune ("FB", 1U, param, len);
+}
+
+/**
+ * @brief FR - RX VFO
+ *
+ * FR; - read, FR0; - VFO A, FR1; - VFO B. The TX VFO follows, split is off
+ *
+ */
+
+static void cat_cmd_fr (char *param, uint32_t len)
+{
+  char reply [CAT_REPLY_SIZE];
+
+  if (len == 0U)
+  {
+    sprintf (reply, "FR%u;", (unsigned int) vfo.active);
+    cat_reply (reply);
+  }
+  else if ((len == 1U) && ((param [0] == '0') || (param [0] == '1')))
+  {
+    if ((uint8_t) (param [0] - '0') != vfo.active)
+    {
+      VFO_Toggle_VFO ();
+    }
+
+    VFO_Set_Split (0U);
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief FT - TX VFO
+ *
+ * FT; - read, FT0; - VFO A, FT1; - VFO B. Split is on if it is not the RX VFO
+ *
+ */
+
+static void cat_cmd_ft (char *param, uint32_t len)
+{
+  char reply [CAT_REPLY_SIZE];
+
+  if (len == 0U)
+  {
+    sprintf (reply, "FT%u;", (unsigned int) (vfo.active ^ vfo.split));
+    cat_reply (reply);
+  }
+  else if ((len == 1U) && ((param [0] == '0') || (param [0] == '1')))
+  {
+    VFO_Set_Split ((uint8_t) (param [0] - '0') != vfo.active);
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief ID - transceiver model
+ *
+ */
+
+static void cat_cmd_id (char *param, uint32_t len)
+{
+  if (len != 0U)
+  {
+    cat_error ();
+    return;
+  }
+
+  cat_reply ("ID" CAT_ID ";");
+}
+
+/**
+ * @brief KS - keyer speed
+ *
+ * KS; - read, KS020; - set 3 digits in WPM
+ *
+ */
+
+static void cat_cmd_ks (char *param, uint32_t len)
+{
+  char     reply [CAT_REPLY_SIZE];
+  uint32_t speed;
+
+  if (len == 0U)
+  {
+    sprintf (reply, "KS%03u;", (unsigned int) cw_keyer.speed);
+    cat_reply (reply);
+  }
+  else if ((len == 3U) && cat_get_number (param, len, &speed))
+  {
+    if (speed < 4U)  speed = 4U;
+    if (speed > 60U) speed = 60U;
+
+    cw_keyer.speed = speed;
+    CW_Set_Speed ();
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief KY - send text by the CW encoder
+ *
+ * KY; - read buffer state: KY0; - ready, KY1; - full
+ * KY <text>; - send up to 24 characters, trailing padding is removed
+ *
+ */
+
+static void cat_cmd_ky (char *param, uint32_t len)
+{
+  if (len == 0U)
+  {
+    cat_reply ((CW_Text_Free () >= CAT_KY_TEXT_SIZE) ? "KY0;" : "KY1;");
+    return;
+  }
+
+  /* P1 is a space, P2 is the text */
+  if ((param [0] != ' ') || (len > (CAT_KY_TEXT_SIZE + 1U)))
+  {
+    cat_error ();
+    return;
+  }
+
+  param++;
+  len--;
+
+  /* Keep one of the padding spaces as a word space */
+  while ((len > 1U) && (param [len - 1U] == ' ') && (param [len - 2U] == ' '))
+  {
+    len--;
+  }
+
+  if (CW_Text_Write (param, len) != len)
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief MD - operating mode
+ *
+ * MD; - read, MD3; - set
+ *
+ */
+
+static void cat_cmd_md (char *param, uint32_t len)
+{
+  char reply [CAT_REPLY_SIZE];
+
+  if (len == 0U)
+  {
+    sprintf (reply, "MD%u;", (unsigned int) trx.mode);
+    cat_reply (reply);
+  }
+  else if ((len == 1U) && (param [0] >= '1') && (param [0] <= '9'))
+  {
+    PTT_Set_Mode (param [0] - '0');
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief RX - receive mode
+ *
+ */
+
+static void cat_cmd_rx (char *param, uint32_t len)
+{
+  PTT_CAT_TX (0U);
+}
+
+/**
+ * @brief TX - transmit mode
+ *
+ * TX; TX0; TX1; TX2; are accepted
+ *
+ */
+
+static void cat_cmd_tx (char *param, uint32_t len)
+{
+  if ((len > 1U) || ((len == 1U) && ((param [0] < '0') || (param [0] > '2'))))
+  {
+    cat_error ();
+    return;
+  }
+
+  PTT_CAT_TX (1U);
+}
+
+/**
+ * @brief ZL - idle ratio and USB suspend, an extension of Kenwood commands
+ *
+ * ZL; - read, see LP_Format ()
+ * ZLR; - clear counters
+ *
+ */
+
+static void cat_cmd_zl (char *param, uint32_t len)
+{
+  char reply [LP_LINE_SIZE];
+
+  if (len == 0U)
+  {
+    LP_Format (reply, sizeof (reply));
+    cat_reply (reply);
+  }
+  else if ((len == 1U) && ((param [0] == 'R') || (param [0] == 'r')))
+  {
+    LP_Reset ();
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief ZM - interrupt latency and load monitor, an extension of Kenwood commands
+ *
+ * ZM; - read, see MON_Format ()
+ * ZMR; - clear maxima and alarms
+ *
+ */
+
+static void cat_cmd_zm (char *param, uint32_t len)
+{
+  char reply [MON_LINE_SIZE];
+
+  if (len == 0U)
+  {
+    MON_Format (reply, sizeof (reply));
+    cat_reply (reply);
+  }
+  else if ((len == 1U) && ((param [0] == 'R') || (param [0] == 'r')))
+  {
+    MON_Reset ();
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+#if PROF_ENABLE
+
+/**
+ * @brief ZP - profiler zones, an extension of Kenwood commands
+ *
+ * ZP; - read number of zones, core clock and size of the audio hot path
+ *       in RAM in bytes, 0 with HOT_RAM=0: ZP6,96000000,nnnn;
+ *
+ * The CW and MIX zones of HOT_RAM=1 and HOT_RAM=0 builds give the cycles
+ * saved by running the hot path without flash wait states
+ * ZPn; - read zone n statistics, see PROF_Format ()
+ * ZPR; - clear statistics
+ *
+ */
+
+static void cat_cmd_zp (char *param, uint32_t len)
+{
+  char reply [PROF_LINE_SIZE];
+
+  if (len == 0U)
+  {
+    sprintf (reply, "ZP%u,%lu,%lu;", (unsigned int) PROF_ZONES, (unsigned long) SystemCoreClock,
+             (unsigned long) (&_ehot - &_shot));
+    cat_reply (reply);
+  }
+  else if ((len == 1U) && ((param [0] == 'R') || (param [0] == 'r')))
+  {
+    PROF_Reset ();
+  }
+  else if ((len == 1U) && PROF_Format (param [0] - '0', reply, sizeof (reply)))
+  {
+    cat_reply (reply);
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+#endif
+
+/**
+ * @brief ZQ - PTT sequencer, an extension of Kenwood commands
+ *
+ * ZQ; - read TX audio delay state, the delay and the longest lead in us:
+ *       ZQ1,10000,21312;
+ * ZQD0; ZQD1; - TX audio delay off or on
+ * ZQn; - read lead and tail of output n, 1 - AMP, 2 - RELAY, see SEQ_Format ()
+ * ZQn,lead,tail; - set them in us, a lead the delay line cannot hold is refused
+ *
+ */
+
+static void cat_cmd_zq (char *param, uint32_t len)
+{
+  char     reply [SEQ_LINE_SIZE];
+  uint32_t value [3];
+
+  if (len == 0U)
+  {
+    sprintf (reply, "ZQ%u,%lu,%lu;", (unsigned int) SEQ_Get_Audio_Delay (),
+             (unsigned long) SEQ_Get_Delay (), (unsigned long) SEQ_Get_Lead_Max ());
+    cat_reply (reply);
+  }
+  else if ((len == 2U) && ((param [0] == 'D') || (param [0] == 'd')) &&
+           ((param [1] == '0') || (param [1] == '1')))
+  {
+    SEQ_Set_Audio_Delay (param [1] - '0');
+  }
+  else if ((len == 1U) && SEQ_Format (param [0] - '0', reply, sizeof (reply)))
+  {
+    cat_reply (reply);
+  }
+  else if (!cat_get_numbers (param, len, value, 3U) || (value [0] > 0xFFU) ||
+           !SEQ_Set_Timing (value [0], value [1], value [2]))
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief ZS - main loop tasks, an extension of Kenwood commands
+ *
+ * ZS; - read number of tasks: ZS6;
+ * ZSn; - read task n statistics, see SCHED_Format ()
+ * ZSR; - clear statistics
+ *
+ */
+
+static void cat_cmd_zs (char *param, uint32_t len)
+{
+  char reply [SCHED_LINE_SIZE];
+
+  if (len == 0U)
+  {
+    sprintf (reply, "ZS%u;", (unsigned int) SCHED_TASKS);
+    cat_reply (reply);
+  }
+  else if ((len == 1U) && ((param [0] == 'R') || (param [0] == 'r')))
+  {
+    SCHED_Reset ();
+  }
+  else if ((len == 1U) && SCHED_Format (param [0] - '0', reply, sizeof (reply)))
+  {
+    cat_reply (reply);
+  }
+  else
+  {
+    cat_error ();
+  }
+}
+
+/**
+ * @brief This function executes a CAT command
+ *
+ * The command is looked up by its two letter name in cat_cmd_table
+ *
+ * @param Command string without terminator
+ * @param Command length
+ */
+
+static void cat_execute (char *cmd, uint32_t len)
+{
+  char name [2];
+
+  if (len < 2U)
+  {
+    cat_error ();
+    return;
+  }
+
+  for (uint32_t i = 0U; i < 2U; i++)
+  {
+    name [i] = cmd [i];
+
+    if ((name [i] >= 'a') && (name [i] <= 'z'))
+    {
+      name [i] -= 'a' - 'A';
+    }
+  }
+
+  for (uint32_t i = 0U; i < (sizeof (cat_cmd_table) / sizeof (cat_cmd_table [0])); i++)
+  {
+    if ((cat_cmd_table [i].name [0] == name [0]) && (cat_cmd_table [i].name [1] == name [1]))
+    {
+      cat_cmd_table [i].handler (cmd + 2U, len - 2U);
+      return;
+    }
+  }
+
+  cat_error ();
+}
+
+/**
+ * @brief This function assembles CAT commands from received bytes
+ *
+ * Commands are terminated with ';', CR or LF.
+ * Too long commands are discarded up to the next terminator.
+ *
+ * @param Received byte
+ */
+
+static void cat_parse_byte (uint8_t byte)
+{
+  if ((byte == ';') || (byte == '\r') || (byte == '\n'))
+  {
+    if ((cat_cmd_len != 0U) && !cat_cmd_overflow)
+    {
+      cat_execute (cat_cmd, cat_cmd_len);
+    }
+
+    cat_cmd_len      = 0U;
+    cat_cmd_overflow = 0U;
+    return;
+  }
+
+  /* One byte is reserved for the terminator */
+  if (cat_cmd_len < (CAT_CMD_SIZE - 1U))
+  {
+    cat_cmd [cat_cmd_len++] = (char) byte;
+  }
+  else
+  {
+    cat_cmd_overflow = 1U;
+  }
+}
+
+/**
+ * @brief This function assembles remote keying frames
+ *
+ * @param Received byte
+ */
+
+static void cat_parse_key_byte (uint8_t byte)
+{
+  uint32_t value;
+
+  cat_key_frame [cat_key_len++] = byte;
+
+  if (cat_key_len < CAT_KEY_FRAME_SIZE) return;
+
+  cat_key_len = 0U;
+
+  value = (uint32_t) cat_key_frame [2]         | ((uint32_t) cat_key_frame [3] << 8U) |
+         ((uint32_t) cat_key_frame [4] << 16U) | ((uint32_t) cat_key_frame [5] << 24U);
+
+  switch (cat_key_frame [1])
+  {
+    case CAT_KEY_UP:
+    case CAT_KEY_DOWN:
+      CW_Remote_Key (cat_key_frame [1] == CAT_KEY_DOWN, value);
+      break;
+    case CAT_KEY_DELAY:
+      CW_Remote_Set_Delay (value);
+      break;
+    case CAT_KEY_EXPORT:
+      EVT_Set_Export (value != 0U);
+      break;
+    default:
+      break;
+  }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function writes a byte to CAT buffer
+ *
+ * It is called from CDC_Receive_FS() in USB interrupt context
+ *
+ * @param Received byte
+ */
+
+void CAT_Buff_Write_Byte (uint8_t byte)
+{
+  if ((cat_buff.wr_ptr - cat_buff.rd_ptr) >= CAT_BUFF_SIZE)
+  {
+    cat_buff.overflows++;
+    return;
+  }
+
+  cat_buff.buff [cat_buff.wr_ptr & (CAT_BUFF_SIZE - 1U)] = byte;
+  cat_buff.wr_ptr++;
+}
+
+/**
+ * @brief This function returns free space of CAT buffer
+ *
+ * @retval Number of bytes
+ */
+
+uint32_t CAT_Buff_Free (void)
+{
+  return CAT_BUFF_SIZE - (cat_buff.wr_ptr - cat_buff.rd_ptr);
+}
+
+/**
+ * @brief This function initialize CAT interface
+ *
+ */
+
+void CAT_Init (void)
+{
+  cat_buff.wr_ptr    = 0U;
+  cat_buff.rd_ptr    = 0U;
+  cat_buff.overflows = 0U;
+
+  cat_cmd_len      = 0U;
+  cat_cmd_overflow = 0U;
+
+  cat_key_len = 0U;
+}
+
+/**
+ * @brief This function parses received CAT data
+ *
+ * It is called from the main loop
+ *
+ */
+
+void CAT_Handler (void)
+{
+  uint8_t byte;
+
+  while (cat_buff.rd_ptr != cat_buff.wr_ptr)
+  {
+    byte = cat_buff.buff [cat_buff.rd_ptr & (CAT_BUFF_SIZE - 1U)];
+    cat_buff.rd_ptr++;
+
+    /* Kenwood commands are plain text, WinKeyer commands start with 0x00,
+     * remote keying frames start with CAT_KEY_SYNC */
+    if ((cat_key_len != 0U) || (!WK_Is_Active () && (byte == CAT_KEY_SYNC)))
+    {
+      cat_parse_key_byte (byte);
+    }
+    else if (WK_Is_Active () || (byte == WK_ADMIN))
+    {
+      WK_Parse_Byte (byte);
+    }
+    else
+    {
+      cat_parse_byte (byte);
+    }
+  }
+}
+
+/****END OF FILE****/
@@ -29,6 +29,13 @@
 #include "cw_gen.h"
 #include "ptt_if.h"
 #include "dds_if.h"
+#include "evt_if.h"
+#include "seq_if.h"
+#include "time_if.h"
+#include "dsp_if.h"
+
+#include <math.h>
+#include <string.h>
 
 /* Private typedef -----------------------------------------------------------*/
 
@@ -54,12 +61,59 @@ typedef struct PaddleState
   uint32_t sm_tbl_ptr;
   uint32_t sm_smooth_len;
 
+  /* Sidetone envelope ptr, Q8, and its direction */
+  int32_t  st_tbl_ptr;
+  uint8_t  st_rising;
+
   uint32_t ultim;
 
   uint32_t cw_char;
   uint32_t sending_char;
+
+  /* CW text encoder */
+  uint32_t text_code;   /* Elements left of the character being sent */
+  int32_t  text_gap;    /* Remaining gap before the next character */
+  int32_t  char_time;   /* Extra gap between characters: 2 dits */
 } PaddleState;
 
+typedef struct CW_Text
+{
+  char          buff [CW_TEXT_BUFF_SIZE];
+  __IO uint32_t wr_ptr;
+  __IO uint32_t rd_ptr;
+  __IO uint8_t  pause;
+} CW_Text;
+
+typedef struct CW_Remote_Event
+{
+  uint32_t time;        /* Playout time in samples */
+  uint8_t  key;
+} CW_Remote_Event;
+
+typedef struct CW_Remote
+{
+  CW_Remote_Event buff [CW_REMOTE_BUFF_SIZE];
+  __IO uint32_t   wr_ptr;
+  __IO uint32_t   rd_ptr;
+  __IO uint8_t    key_is_on;   /* Key state being played */
+  uint8_t         synced;
+  uint32_t        delay;       /* Playout delay in samples */
+  uint32_t        base_stamp;  /* Sender time stamp in us ... */
+  uint32_t        base_time;   /* ... and its playout time */
+  uint32_t        last_time;   /* Playout time of the last event */
+} CW_Remote;
+
+typedef struct CW_Mute
+{
+  int16_t         *block;                     /* Audio block being rendered */
+  int16_t         rx [CW_BLOCK_MAX * 2];      /* RX audio of the sidetone channels */
+  int16_t         st_env [CW_BLOCK_MAX];      /* Sidetone envelope of the block, Q15 */
+  int16_t         tx_env [CW_BLOCK_MAX];      /* TX signal envelope of the block, Q15 */
+  int16_t         delay [DSP_DELAY_SIZE];     /* TX signal envelope as the TX signal is delayed */
+  uint32_t        wr_ptr;
+  uint32_t        length;                     /* TX signal delay, samples */
+} CW_Mute;
+
 
 /* Private define ------------------------------------------------------------*/
 // States
@@ -79,7 +133,9 @@ typedef struct PaddleState
 #define CW_IAMBIC_A         0x00
 #define CW_IAMBIC_B         0x10
 
-#define CW_SMOOTH_LEN       2
+#ifndef CW_SMOOTH_LEN
+#define CW_SMOOTH_LEN       2       /* Samples per envelope table step */
+#endif
 
 /**
  *  CW_SMOOTH_STEPS = (CW_SMOOTH_TBL_SIZE * CW_SMOOTH_LEN) / (USBD_AUDIO_FREQ / 1000U) + 1U
@@ -87,9 +143,9 @@ typedef struct PaddleState
  *  with CW_SMOOTH_TBL_SIZE = 128
  *  2 => ~5.3ms for edges, ~ 6 steps of 1ms are required
  *  1 => ~2.7ms for edges, ~ 3 steps of 1ms are required
- *  3 => =8.0ms for edges, = 8 steps of 1ms are required
+ *  3 => =8.0ms for edges, = 9 steps of 1ms are required
  */
-#define CW_SMOOTH_STEPS     6       /* 1 step = 1ms for internal keyer */
+#define CW_SMOOTH_STEPS     ((128 * CW_SMOOTH_LEN) / CW_SAMPLES_PER_MS + 1)  /* 1 step = 1ms for internal keyer */
 
 /* Private macro -------------------------------------------------------------*/
 
@@ -99,56 +155,63 @@ typedef struct PaddleState
 
 PaddleState  ps;
 CW_Keyer cw_keyer;
+CW_Text  cw_text;
+
+CW_Route        cw_route;
+CW_IQ           cw_iq;
+CW_Remote       cw_remote;
+CW_Remote_Stats cw_remote_stats;
+CW_Mute         cw_mute;
+
+/* Audio sample counter, the timebase of remote keying */
 
-/* Blackman-Harris function to keep CW signal bandwidth narrow */
+static __IO uint32_t cw_sample_clock;
+
+/* Time of the first sample of the current audio buffer, us */
+
+static uint32_t cw_block_time;
+
+/**
+ *  Morse code table for ASCII 0x20...0x5F
+ *
+ *  Elements are read from LSB: 0 = dit, 1 = dah.
+ *  The highest set bit marks the end of the character, 0 = no code.
+ */
+
+static __HOT_DATA const uint8_t cw_morse_table [64] =
+{
+  0x00, 0x75, 0x52, 0x00, 0xC8, 0x00, 0x22, 0x5E,  /* SP ! " # $ % & ' */
+  0x2D, 0x6D, 0x00, 0x2A, 0x73, 0x61, 0x6A, 0x29,  /* (  ) * + , - . / */
+  0x3F, 0x3E, 0x3C, 0x38, 0x30, 0x20, 0x21, 0x23,  /* 0  1 2 3 4 5 6 7 */
+  0x27, 0x2F, 0x47, 0x55, 0x00, 0x31, 0x00, 0x4C,  /* 8  9 : ; < = > ? */
+  0x56, 0x06, 0x11, 0x15, 0x09, 0x02, 0x14, 0x0B,  /* @  A B C D E F G */
+  0x10, 0x04, 0x1E, 0x0D, 0x12, 0x07, 0x05, 0x0F,  /* H  I J K L M N O */
+  0x16, 0x1B, 0x0A, 0x08, 0x03, 0x0C, 0x18, 0x0E,  /* P  Q R S T U V W */
+  0x19, 0x1D, 0x13, 0x00, 0x00, 0x00, 0x00, 0x6C,  /* X  Y Z [ \ ] ^ _ */
+};
+
+/* Blackman-Harris function to keep CW signal bandwidth narrow, Q15 */
 
 #define CW_SMOOTH_TBL_SIZE  128
 
-static const float sm_table [CW_SMOOTH_TBL_SIZE] =
-{
-    0.0000000000000000, 0.0000686004957883,
-    0.0000945542356652, 0.0001383179721175, 0.0002006529396865,
-    0.0002826248158738, 0.0003856036471126, 0.0005112637206964,
-    0.0006615833583608, 0.0008388446022225, 0.0010456327590236,
-    0.0012848357641460, 0.0015596433227128, 0.0018735457812732,
-    0.0022303326801620, 0.0026340909336119, 0.0030892025821568,
-    0.0036003420597745, 0.0041724729166402, 0.0048108439372987,
-    0.0055209845935232, 0.0063086997711494, 0.0071800637107376,
-    0.0081414131030473, 0.0091993392820062, 0.0103606794601087,
-    0.0116325069539978, 0.0130221203513468, 0.0145370315740592,
-    0.0161849527972270, 0.0179737821882093, 0.0199115884355984,
-    0.0220065940436903, 0.0242671573743564, 0.0267017534248783,
-    0.0293189533373318, 0.0321274026424438, 0.0351357982484650,
-    0.0383528641934459, 0.0417873261873527, 0.0454478849786327,
-    0.0493431885881256, 0.0534818034615354, 0.0578721846000008,
-    0.0625226447365667, 0.0674413226345205, 0.0726361505915551,
-    0.0781148212415210, 0.0838847537530600, 0.0899530595316440,
-    0.0963265075384118, 0.1030114893456630, 0.1100139840548870,
-    0.1173395232087210, 0.1249931558332360, 0.1329794137513460,
-    0.1413022773119520, 0.1499651416825930, 0.1589707838558700,
-    0.1683213305216760, 0.1780182269583640, 0.1880622070962730,
-    0.1984532649066170, 0.2091906272675180, 0.2202727284569900,
-    0.2316971864198910, 0.2434607809523230, 0.2555594339426260,
-    0.2679881918029900, 0.2807412102198870, 0.2938117413448940,
-    0.3071921235401840, 0.3208737737849510, 0.3348471828403530,
-    0.3491019132612700, 0.3636266003332790, 0.3784089560027740,
-    0.3934357758572420, 0.4086929492012480, 0.4241654722618500,
-    0.4398374645449960, 0.4556921883519000, 0.4717120714516800,
-    0.4878787328935640, 0.5041730119288920, 0.5205749999999980,
-    0.5370640757398780, 0.5536189429134430, 0.5702176712181650,
-    0.5868377398491150, 0.6034560837207990, 0.6200491422259460,
-    0.6365929103995070, 0.6530629923446170, 0.6694346567663080,
-    0.6856828944482830, 0.7017824774982180, 0.7177080201778180,
-    0.7334340411253520, 0.7489350267705930, 0.7641854957350820,
-    0.7791600640044710, 0.7938335106543350, 0.8081808439064380,
-    0.8221773672888840, 0.8357987456709900, 0.8490210709420900,
-    0.8618209271027980, 0.8741754545375520, 0.8860624132385800,
-    0.8974602447536510, 0.9083481326332570, 0.9187060611570670,
-    0.9285148721246550, 0.9377563195016140, 0.9464131217191720,
-    0.9544690114333140, 0.9619087825581750, 0.9687183343980040,
-    0.9748847127123550, 0.9803961475602210, 0.9852420877805500,
-    0.9894132319790110, 0.9929015559037870, 0.9957003361066840,
-    0.9978041697997700, 0.9992089908321180, 0.9999120817258750
+static __HOT_DATA const int16_t sm_table [CW_SMOOTH_TBL_SIZE] =
+{
+        0,     2,     3,     5,     7,     9,    13,    17,
+       22,    27,    34,    42,    51,    61,    73,    86,
+      101,   118,   137,   158,   181,   207,   235,   267,
+      301,   339,   381,   427,   476,   530,   589,   652,
+      721,   795,   875,   961,  1053,  1151,  1257,  1369,
+     1489,  1617,  1752,  1896,  2049,  2210,  2380,  2560,
+     2749,  2947,  3156,  3375,  3605,  3845,  4096,  4357,
+     4630,  4914,  5209,  5515,  5833,  6162,  6503,  6855,
+     7218,  7592,  7977,  8374,  8781,  9199,  9627, 10066,
+    10514, 10972, 11439, 11915, 12399, 12892, 13392, 13899,
+    14412, 14932, 15457, 15986, 16520, 17058, 17598, 18140,
+    18684, 19229, 19773, 20317, 20859, 21399, 21935, 22468,
+    22995, 23517, 24032, 24540, 25040, 25531, 26012, 26482,
+    26940, 27387, 27820, 28239, 28644, 29034, 29407, 29764,
+    30103, 30425, 30727, 31011, 31275, 31519, 31742, 31944,
+    32125, 32283, 32420, 32534, 32626, 32695, 32741, 32764
 };
 
 /* Private function prototypes -----------------------------------------------*/
@@ -166,7 +229,7 @@ extern PTT_TypeDef ptt;
  *
  */
 
-static void cw_ptt_set_rx (void)
+static __HOT_FUNC void cw_ptt_set_rx (void)
 {
   PTT_Key_Off_Time ();
 }
@@ -176,7 +239,7 @@ static void cw_ptt_set_rx (void)
  *
  */
 
-static void cw_set_delay (void)
+static __HOT_FUNC void cw_set_delay (void)
 {
   ps.break_timer = 1;
 }
@@ -186,7 +249,7 @@ static void cw_set_delay (void)
  *
  */
 
-static void cw_get_paddle_state (void)
+static __HOT_FUNC void cw_get_paddle_state (void)
 {
   if (ptt.key_dah_is_on)
   {
@@ -209,7 +272,7 @@ static void cw_get_paddle_state (void)
  *
  */
 
-static void cw_get_first_paddle (void)
+static __HOT_FUNC void cw_get_first_paddle (void)
 {
   if (cw_keyer.mode == ULTIMATE)
   {
@@ -226,15 +289,79 @@ static void cw_get_first_paddle (void)
 }
 
 
+/**
+ * @brief This function returns next element of CW text
+ *
+ * @retval CW_DIT_L, CW_DAH_L or 0 if there is nothing to send now
+ */
+
+static __HOT_FUNC uint32_t cw_text_get_element (void)
+{
+  uint32_t element;
+  char     c;
+
+  if (ps.text_gap > 0)
+  {
+    ps.text_gap--;
+    return 0U;
+  }
+
+  while (ps.text_code <= 1U)
+  {
+    if ((cw_text.rd_ptr == cw_text.wr_ptr) || cw_text.pause)
+    {
+      ps.text_code = 0U;
+      return 0U;
+    }
+
+    c = cw_text.buff [cw_text.rd_ptr & (CW_TEXT_BUFF_SIZE - 1U)];
+    cw_text.rd_ptr++;
+
+    if ((c >= 'a') && (c <= 'z'))
+    {
+      c -= 'a' - 'A';
+    }
+
+    if ((c == ' ') || ((c > ' ') && (c < 0x60) && cw_morse_table [c - ' ']))
+    {
+      CW_Text_Sent_Callback (c);
+    }
+
+    if (c == ' ')
+    {
+      /* Word space is 7 dits: 3 dits of character space + 4 dits */
+      ps.text_gap = 2 * ps.char_time;
+      return 0U;
+    }
+
+    if ((c > ' ') && (c < 0x60))
+    {
+      ps.text_code = cw_morse_table [c - ' '];
+    }
+  }
+
+  element = (ps.text_code & 1U) ? CW_DAH_L : CW_DIT_L;
+  ps.text_code >>= 1;
+
+  if (ps.text_code == 1U)
+  {
+    /* Last element: character space is 3 dits, 1 dit is made by keyer pause */
+    ps.text_code = 0U;
+    ps.text_gap  = ps.char_time;
+  }
+
+  return element;
+}
+
 /**
  * @brief This function removes clicks at start end end of tone
  *
  */
 
-static void cw_chirp_off (int16_t *i_buffer, int16_t *q_buffer, uint8_t rising)
+static __HOT_FUNC void cw_chirp_off (int16_t *i_buffer, int16_t *q_buffer, uint8_t rising)
 {
-  *i_buffer = (int16_t) ((float) *i_buffer * sm_table [ps.sm_tbl_ptr]);
-  *q_buffer = (int16_t) ((float) *q_buffer * sm_table [ps.sm_tbl_ptr]);
+  *i_buffer = (int16_t) ((*i_buffer * sm_table [ps.sm_tbl_ptr]) >> 15);
+  *q_buffer = (int16_t) ((*q_buffer * sm_table [ps.sm_tbl_ptr]) >> 15);
 
   ps.sm_smooth_len++;
 
@@ -259,24 +386,189 @@ static void cw_chirp_off (int16_t *i_buffer, int16_t *q_buffer, uint8_t rising)
   }
 }
 
+/**
+ * @brief This function moves sidetone envelope towards its edge
+ *
+ */
+
+static __HOT_FUNC void cw_sidetone_step (void)
+{
+  if (ps.st_rising)
+  {
+    ps.st_tbl_ptr += cw_route.st_step;
+
+    if (ps.st_tbl_ptr > ((CW_SMOOTH_TBL_SIZE - 1) << 8))
+    {
+      ps.st_tbl_ptr = (CW_SMOOTH_TBL_SIZE - 1) << 8;
+    }
+  }
+  else
+  {
+    ps.st_tbl_ptr -= cw_route.st_step;
+
+    if (ps.st_tbl_ptr < 0)
+    {
+      ps.st_tbl_ptr = 0;
+    }
+  }
+}
+
+/**
+ * @brief This function prepares the channels for a block
+ *
+ * TX channels are cleared. RX audio of the sidetone channels is moved
+ * aside, it is muted and mixed back by cw_rx_mute ()
+ *
+ * @param Stereo audio buffer pointer
+ * @param number of samples
+ */
+
+static __HOT_FUNC void cw_route_clear (int16_t *buffer, uint16_t size)
+{
+  cw_mute.block = buffer;
+
+  for (uint8_t ch = 0U; ch < 2U; ch++)
+  {
+    for (uint16_t i = ch; i < size; i += 2U)
+    {
+      if (cw_route.out [ch] == CW_ROUTE_SIDETONE)
+      {
+        cw_mute.rx [i] = buffer [i];
+      }
+
+      buffer [i] = 0;
+    }
+  }
+
+  for (uint16_t n = 0U; n < (size / 2U); n++)
+  {
+    cw_mute.st_env [n] = 0;
+    cw_mute.tx_env [n] = 0;
+  }
+}
+
+/**
+ * @brief This function mixes muted RX audio into the sidetone channels
+ *
+ * TX signal is delayed by the PTT lead, so RX audio is muted with the
+ * sidetone envelope or the TX signal envelope delayed the same way,
+ * whichever is higher. RX comes back only when the delayed RF is over
+ *
+ * @param Stereo audio buffer pointer
+ * @param number of samples
+ */
+
+static __HOT_FUNC void cw_rx_mute (int16_t *buffer, uint16_t size)
+{
+  int32_t mute, rx_gain;
+
+  for (uint16_t i = 0U, n = 0U; i < size; i += 2U, n++)
+  {
+    cw_mute.delay [cw_mute.wr_ptr & (DSP_DELAY_SIZE - 1U)] = cw_mute.tx_env [n];
+
+    mute = cw_mute.delay [(cw_mute.wr_ptr - cw_mute.length) & (DSP_DELAY_SIZE - 1U)];
+
+    if (mute < cw_mute.st_env [n])
+    {
+      mute = cw_mute.st_env [n];
+    }
+
+    cw_mute.wr_ptr++;
+
+    rx_gain = CW_GAIN_MAX - mute;
+
+    for (uint8_t ch = 0U; ch < 2U; ch++)
+    {
+      if (cw_route.out [ch] != CW_ROUTE_SIDETONE) continue;
+
+      if (mute)
+      {
+        buffer [i + ch] += (cw_mute.rx [i + ch] * rx_gain) >> 15;
+      }
+      else
+      {
+        buffer [i + ch] += cw_mute.rx [i + ch];
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief This function corrects I/Q TX signal imbalance
+ *
+ * Q is predistorted as Q' = g * (Q * cos (p) + I * sin (p))
+ * with coefficients taken once per block
+ *
+ * @param Stereo audio buffer pointer, I left, Q right
+ * @param number of samples
+ */
+
+static __HOT_FUNC void cw_iq_correct (int16_t *buffer, uint16_t size)
+{
+  int32_t q_cos = cw_iq.q_cos;
+  int32_t q_sin = cw_iq.q_sin;
+  int32_t i_tx, q_tx;
+
+  if ((cw_route.out [0] != CW_ROUTE_TX_I) || (cw_route.out [1] != CW_ROUTE_TX_Q)) return;
+
+  for (uint16_t i = 0U; i < size; i += 2U)
+  {
+    i_tx = buffer [i + 0];
+    q_tx = (buffer [i + 1] * q_cos + i_tx * q_sin) >> 14;
+
+    if (q_tx > 32767)
+    {
+      q_tx = 32767;
+    }
+    else if (q_tx < -32768)
+    {
+      q_tx = -32768;
+    }
+
+    if (cw_iq.swap)
+    {
+      buffer [i + 0] = q_tx;
+      buffer [i + 1] = i_tx;
+    }
+    else
+    {
+      buffer [i + 1] = q_tx;
+    }
+  }
+}
+
 /**
  * @brief This function puts CW tone to audio buffer
  *
- * @param IQ audio buffer pointers
+ * One DDS sample gives both TX signal and sidetone. Each of them has
+ * its own envelope and level and goes to channels set by the route.
+ * The envelopes are kept for cw_rx_mute (), so RX audio comes back
+ * smoothly between elements
+ *
+ * @param Stereo audio buffer pointer
  * @param CW keyer mode: 1 = straight mode, 0 = any other modes
- * @param scaling = CW tone volume 0...256
  */
 
-static void cw_tone_gen (int16_t *i_buffer, int16_t *q_buffer, uint8_t straight)
+static __HOT_FUNC void cw_tone_gen (int16_t *buffer, uint8_t straight)
 {
-  uint8_t scaling = 96U; /* CW tone volume 0...255 */
+  uint32_t n = (uint32_t) (buffer - cw_mute.block) / 2U;
+  int16_t  i_dds, q_dds;
+  int32_t  st_env, st;
+
+  DDS_Get_IQ_Sample (&i_dds, &q_dds);
 
-  int16_t i_buf = *i_buffer;
-  int16_t q_buf = *q_buffer;
+  /* Sidetone gain, Q15 */
+  st_env = sm_table [ps.st_tbl_ptr >> 8];
+  st     = (((i_dds * st_env) >> 15) * cw_route.st_level) >> 15;
 
-  int16_t i_dds, q_dds;
+  cw_mute.st_env [n] = (int16_t) st_env;
 
-  DDS_Get_IQ_Sample (&i_dds, &q_dds);
+  /* I/Q TX signal is at IF offset instead of the pitch */
+  if (cw_iq.is_on)
+  {
+    DDS_Get_TX_IQ_Sample (&i_dds, &q_dds);
+  }
 
   if (straight)
   {
@@ -284,6 +576,7 @@ static void cw_tone_gen (int16_t *i_buffer, int16_t *q_buffer, uint8_t straight)
     if (ps.key_state == 3U)
     {
       cw_chirp_off (&i_dds, &q_dds, 1U);
+      ps.st_rising = 1U;
 
       if (ps.sm_tbl_ptr >= (CW_SMOOTH_TBL_SIZE - 1U))
       {
@@ -297,6 +590,7 @@ static void cw_tone_gen (int16_t *i_buffer, int16_t *q_buffer, uint8_t straight)
     if (ps.key_state == 1U)
     {
       cw_chirp_off (&i_dds, &q_dds, 0U);
+      ps.st_rising = 0U;
 
       if (ps.sm_tbl_ptr == 0U)
       {
@@ -311,6 +605,7 @@ static void cw_tone_gen (int16_t *i_buffer, int16_t *q_buffer, uint8_t straight)
     if (ps.key_timer > (ps.dit_time / 2))
     {
       cw_chirp_off (&i_dds, &q_dds, 1U);
+      ps.st_rising = 1U;
 
       if (ps.sm_tbl_ptr >= (CW_SMOOTH_TBL_SIZE - 1U))
       {
@@ -323,6 +618,7 @@ static void cw_tone_gen (int16_t *i_buffer, int16_t *q_buffer, uint8_t straight)
     if (ps.key_timer <= CW_SMOOTH_STEPS)
     {
       cw_chirp_off (&i_dds, &q_dds, 0U);
+      ps.st_rising = 0U;
 
       if (ps.sm_tbl_ptr == 0U)
       {
@@ -332,14 +628,82 @@ static void cw_tone_gen (int16_t *i_buffer, int16_t *q_buffer, uint8_t straight)
     }
   }
 
-  i_dds = (i_dds * scaling) / 256U;
-  q_dds = (q_dds * scaling) / 256U;
+  cw_sidetone_step ();
+
+  cw_mute.tx_env [n] = sm_table [ps.sm_tbl_ptr];
+
+  for (uint8_t ch = 0U; ch < 2U; ch++)
+  {
+    switch (cw_route.out [ch])
+    {
+      case CW_ROUTE_SIDETONE:
+        buffer [ch] = st;
+        break;
+      case CW_ROUTE_TX_I:
+        buffer [ch] = (i_dds * cw_route.tx_level) >> 15;
+        break;
+      case CW_ROUTE_TX_Q:
+        buffer [ch] = (q_dds * cw_route.tx_level) >> 15;
+        break;
+      default:
+        buffer [ch] = 0;
+        break;
+    }
+  }
+}
+
+/**
+ * @brief This function reports keyer output edge
+ *
+ * @param 1 - key down, 0 - key up
+ * @param Sample offset in the current audio buffer
+ */
+
+static __HOT_FUNC void cw_key_edge (uint8_t key, uint32_t offset)
+{
+  uint32_t time = cw_block_time + (offset * 1000U) / CW_SAMPLES_PER_MS;
+
+  EVT_Put_Time (key ? EVT_KEY_DOWN : EVT_KEY_UP, time);
+  SEQ_Key (key, time);
+}
+
+/**
+ * @brief This function sets straight key state
+ *
+ * @param 1 - key down, 0 - key up
+ * @param Sample offset in the current audio buffer
+ */
+
+static __HOT_FUNC void cw_set_key (uint8_t key, uint32_t offset)
+{
+  if (key)
+  {
+    if (ps.key_state == 0U)   /* Is a CW key up? */
+    {
+      ps.key_state = 3U;      /* It's a rising edge of CW signal */
+      cw_key_edge (1U, offset);
+    }
+  }
+  else if (ps.key_state > 1U)
+  {
+      ps.key_state = 1U;      /* It's a falling edge of CW signal */
+      cw_key_edge (0U, offset);
+  }
+}
+
+/**
+ * @brief This function checks if a remote key event has to be played
+ *
+ * @param Sample offset in the current audio buffer
+ * @retval 1 if the event is due
+ */
 
-  i_buf = (i_buf * (256 - scaling)) / 256U;
-  q_buf = (q_buf * (256 - scaling)) / 256U;
+static __HOT_FUNC uint8_t cw_remote_is_due (uint32_t offset)
+{
+  if (cw_remote.rd_ptr == cw_remote.wr_ptr) return 0U;
 
-  *i_buffer = i_dds + i_buf;
-  *q_buffer = q_dds + q_buf;
+  return (int32_t) (cw_remote.buff [cw_remote.rd_ptr & (CW_REMOTE_BUFF_SIZE - 1U)].time
+                    - (cw_sample_clock + offset)) <= 0;
 }
 
 /**
@@ -349,7 +713,7 @@ static void cw_tone_gen (int16_t *i_buffer, int16_t *q_buffer, uint8_t straight)
  * @param number of samples
  */
 
-void cw_iambic_keyer_handler (int16_t *i_buffer, int16_t *q_buffer, uint16_t size)
+__HOT_FUNC void cw_iambic_keyer_handler (int16_t *buffer, uint16_t size)
 {
   uint8_t  repeat;
   uint16_t i;
@@ -365,6 +729,25 @@ void cw_iambic_keyer_handler (int16_t *i_buffer, int16_t *q_buffer, uint16_t siz
         repeat = 0U;
 
         cw_get_paddle_state ();
+
+        if (CW_Text_Pending ())
+        {
+          if (ps.port_state & (CW_DAH_L | CW_DIT_L))
+          {
+            /* Paddles break in CW text sending */
+            CW_Text_Clear ();
+          }
+          else
+          {
+            ps.port_state |= cw_text_get_element ();
+
+            if (ps.port_state & (CW_DAH_L | CW_DIT_L))
+            {
+              PTT_Key_On ();
+            }
+          }
+        }
+
         /* If at least one paddle is still or has been recently pressed */
         if (ps.port_state & ( CW_DAH_L | CW_DIT_L))
         {
@@ -392,7 +775,7 @@ void cw_iambic_keyer_handler (int16_t *i_buffer, int16_t *q_buffer, uint16_t siz
             }
           }
 
-          if (ps.break_timer > 0 && !ps.sending_char)
+          if (ps.break_timer > 0 && !ps.sending_char && !CW_Text_Pending ())
           {
             ps.break_timer--;
 
@@ -418,6 +801,7 @@ void cw_iambic_keyer_handler (int16_t *i_buffer, int16_t *q_buffer, uint16_t siz
           ps.cw_state    = CW_KEY_DOWN;
           ps.key_timer   = ps.dit_time;
           ps.cw_char     = ps.cw_char * 4 + 2;
+          cw_key_edge (1U, 0U);
         }
         else
         {
@@ -433,6 +817,7 @@ void cw_iambic_keyer_handler (int16_t *i_buffer, int16_t *q_buffer, uint16_t siz
           ps.cw_state  = CW_KEY_DOWN;
           ps.key_timer = ps.dah_time;
           ps.cw_char   = ps.cw_char * 4 + 3;
+          cw_key_edge (1U, 0U);
         }
         else
         {
@@ -445,11 +830,12 @@ void cw_iambic_keyer_handler (int16_t *i_buffer, int16_t *q_buffer, uint16_t siz
       case CW_KEY_DOWN:
       {
         ps.sm_tbl_ptr = 0;
+        ps.st_tbl_ptr = 0;
 
         for (i = 0U; i < size; i += 2U)
         {
           /* This is CW tone generation call */
-          cw_tone_gen (&i_buffer [i+0], &i_buffer [i+1], 0U);
+          cw_tone_gen (&buffer [i], 0U);
 
           if (ps.key_timer == 0U) break;
         }
@@ -469,13 +855,14 @@ void cw_iambic_keyer_handler (int16_t *i_buffer, int16_t *q_buffer, uint16_t siz
         {
           ps.key_timer = ps.pause_time;
           ps.cw_state  = CW_PAUSE;
+          cw_key_edge (0U, 0U);
         }
         else
         {
           for (i = 0U; i < size; i += 2U)
           {
             /* This is CW tone generation call */
-            cw_tone_gen (&i_buffer [i+0], &i_buffer [i+1], 0U);
+            cw_tone_gen (&buffer [i], 0U);
 
             if (ps.key_timer == 0U) break;
           }
@@ -577,6 +964,31 @@ void CW_Set_Speed (void)
   ps.dah_time   = (dah_time   + weight_corr) / 100;
   ps.pause_time = (pause_time - weight_corr) / 100;
   ps.space_time =  space_time / 100;
+  ps.char_time  =  2 * 120000 / cw_keyer.speed / 100;
+}
+
+/**
+ * @brief This function resets the keyer, the CW text and remote keying
+ *
+ * All the keyer state goes back to power up, the settings are made after it
+ */
+
+void CW_Init (void)
+{
+  memset (&ps,              0, sizeof (ps));
+  memset (&cw_text,         0, sizeof (cw_text));
+  memset (&cw_remote,       0, sizeof (cw_remote));
+  memset (&cw_remote_stats, 0, sizeof (cw_remote_stats));
+  memset (&cw_iq,           0, sizeof (cw_iq));
+
+  /* The TX signal delay is a setting, it is kept */
+  memset (cw_mute.delay, 0, sizeof (cw_mute.delay));
+  cw_mute.wr_ptr = 0U;
+
+  cw_sample_clock = 0U;
+  cw_block_time   = 0U;
+
+  DDS_Init ();
 }
 
 /**
@@ -594,6 +1006,10 @@ void CW_Set_Keyer (void)
   ps.key_timer = 0;
   ps.key_state = 0;
 
+  /* An element broken by the mode change must not leave the envelope up */
+  ps.sm_tbl_ptr = 0;
+  ps.st_tbl_ptr = 0;
+
 
   switch (cw_keyer.mode)
   {
@@ -612,10 +1028,266 @@ void CW_Set_Keyer (void)
   ps.sending_char = 0;
 }
 
+/**
+ * @brief This function puts text to CW encoder buffer
+ *
+ * The text is sent by the keyer with its own timing
+ *
+ * @param Text pointer
+ * @param Text length
+ * @retval Number of characters put to the buffer
+ */
+
+uint16_t CW_Text_Write (const char *text, uint16_t len)
+{
+  uint16_t free = CW_Text_Free ();
+
+  if (len > free)
+  {
+    len = free;
+  }
+
+  for (uint16_t i = 0U; i < len; i++)
+  {
+    cw_text.buff [(cw_text.wr_ptr + i) & (CW_TEXT_BUFF_SIZE - 1U)] = text [i];
+  }
+
+  cw_text.wr_ptr += len;
+
+  return len;
+}
+
+/**
+ * @brief This function returns free space of CW encoder buffer
+ *
+ * @retval Number of characters
+ */
+
+uint16_t CW_Text_Free (void)
+{
+  return CW_TEXT_BUFF_SIZE - (cw_text.wr_ptr - cw_text.rd_ptr);
+}
+
+/**
+ * @brief This function checks if CW encoder has something to send
+ *
+ * @retval 1 if there is a text in the buffer or a character is being sent
+ */
+
+__HOT_FUNC uint8_t CW_Text_Pending (void)
+{
+  return (cw_text.rd_ptr != cw_text.wr_ptr) || (ps.text_code > 1U) || (ps.text_gap > 0);
+}
+
+/**
+ * @brief This function returns CW encoder buffer input pointer
+ *
+ * @retval Free running position of the next character
+ */
+
+uint32_t CW_Text_Input_Ptr (void)
+{
+  return cw_text.wr_ptr;
+}
+
+/**
+ * @brief This function replaces a character which is not sent yet
+ *
+ * @param Free running position of the character
+ * @param New character
+ * @retval 1 if the character has been replaced
+ */
+
+uint8_t CW_Text_Overwrite (uint32_t pos, char c)
+{
+  if (((int32_t) (cw_text.wr_ptr - pos) <= 0) || ((int32_t) (pos - cw_text.rd_ptr) < 0))
+  {
+    return 0U;
+  }
+
+  cw_text.buff [pos & (CW_TEXT_BUFF_SIZE - 1U)] = c;
+
+  return 1U;
+}
+
+/**
+ * @brief This function removes the last character which is not sent yet
+ *
+ */
+
+void CW_Text_Backspace (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+
+  /* The keyer must not take the character while it is being removed */
+  __disable_irq ();
+
+  if (cw_text.wr_ptr != cw_text.rd_ptr)
+  {
+    cw_text.wr_ptr--;
+  }
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function pauses CW encoder after the current character
+ *
+ * @param 1 - pause, 0 - resume
+ */
+
+void CW_Text_Pause (uint8_t pause)
+{
+  cw_text.pause = pause;
+}
+
+/**
+ * @brief This function is called when the CW encoder starts sending a character
+ *
+ * It is called in audio interrupt context
+ *
+ * @param Character
+ */
+
+__weak __HOT_FUNC void CW_Text_Sent_Callback (char c)
+{
+  UNUSED (c);
+}
+
+/**
+ * @brief This function clears CW encoder buffer
+ *
+ * The text is dropped at once, so a text written next is sent. The element
+ * being keyed is completed by the keyer
+ */
+
+__HOT_FUNC void CW_Text_Clear (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+
+  /* The keyer must not take a character while the buffer is cleared */
+  __disable_irq ();
+
+  cw_text.rd_ptr = cw_text.wr_ptr;
+  ps.text_code   = 0U;
+  ps.text_gap    = 0;
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function stops keying at once
+ *
+ * The text and the remote key events are dropped and the keyer is reset,
+ * so nothing is keyed until the key is used again. It is called before
+ * the core stops, the key out line is released by the sequencer
+ */
+
+void CW_Key_Off (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+
+  __disable_irq ();
+
+  CW_Text_Clear ();
+
+  cw_remote.rd_ptr    = cw_remote.wr_ptr;
+  cw_remote.key_is_on = 0U;
+  cw_remote.synced    = 0U;
+
+  CW_Set_Keyer ();
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function puts remote key event to the jitter buffer
+ *
+ * The event is played at its sender time stamp plus playout delay.
+ * The timing is taken again when the buffer is empty and the key is up
+ * for a long time or the event is late.
+ *
+ * @param 1 - key down, 0 - key up
+ * @param Sender time stamp in us
+ */
+
+void CW_Remote_Key (uint8_t key, uint32_t stamp)
+{
+  uint32_t now = cw_sample_clock;
+  uint32_t time;
+  int32_t  diff;
+
+  cw_remote_stats.events++;
+
+  if ((cw_remote.wr_ptr - cw_remote.rd_ptr) >= CW_REMOTE_BUFF_SIZE)
+  {
+    cw_remote_stats.dropped++;
+    return;
+  }
+
+  diff = (int32_t) (stamp - cw_remote.base_stamp);
+
+  if (diff < 0)
+  {
+    diff = 0;
+  }
+
+  time = cw_remote.base_time + (uint32_t) (((uint64_t) diff * CW_SAMPLES_PER_MS) / 1000U);
+
+  if ((cw_remote.wr_ptr == cw_remote.rd_ptr) && !cw_remote.key_is_on &&
+      (!cw_remote.synced || ((int32_t) (time - now) < 0) ||
+       ((int32_t) (now - cw_remote.last_time) > (CW_REMOTE_IDLE * CW_SAMPLES_PER_MS))))
+  {
+    cw_remote.base_stamp = stamp;
+    cw_remote.base_time  = now + cw_remote.delay;
+    cw_remote.synced     = 1U;
+    time = cw_remote.base_time;
+
+    cw_remote_stats.resyncs++;
+  }
+
+  if ((int32_t) (time - now) < 0)
+  {
+    cw_remote_stats.late++;
+    time = now;
+  }
+
+  /* Events are played in order of arrival */
+  if ((int32_t) (time - cw_remote.last_time) < 0)
+  {
+    time = cw_remote.last_time;
+  }
+
+  cw_remote.buff [cw_remote.wr_ptr & (CW_REMOTE_BUFF_SIZE - 1U)].time = time;
+  cw_remote.buff [cw_remote.wr_ptr & (CW_REMOTE_BUFF_SIZE - 1U)].key  = key;
+  cw_remote.wr_ptr++;
+
+  cw_remote.last_time = time;
+}
+
+/**
+ * @brief This function sets playout delay of remote keying
+ *
+ * @param Delay in ms
+ */
+
+void CW_Remote_Set_Delay (uint32_t delay)
+{
+  if (delay > CW_REMOTE_DELAY_MAX)
+  {
+    delay = CW_REMOTE_DELAY_MAX;
+  }
+
+  cw_remote.delay  = delay * CW_SAMPLES_PER_MS;
+  cw_remote.synced = 0U;
+}
+
 /**
  * @brief This function sets CW tone pitch
  *
- * @param CW tone pitch in Hz
+ * It is safe to call at any rate, the new DDS step is taken at once
+ *
+ * @param CW tone pitch in Hz, 1 Hz resolution
  * @param Audio devise sample rate in Hz
  */
 
@@ -625,43 +1297,196 @@ void CW_Set_Pitch (uint32_t freq, uint32_t sample_rate)
 }
 
 /**
- * @brief called every 1000u (== 1000Hz) from I2S IRQ, does cw tone generation
+ * @brief This function sets sources of left and right channels
  *
- * @param IQ audio buffer pointers
- * @param number of samples
+ * @param Left channel source
+ * @param Right channel source
+ */
+
+void CW_Set_Route (uint8_t left, uint8_t right)
+{
+  cw_route.out [0] = left;
+  cw_route.out [1] = right;
+}
+
+/**
+ * @brief This function sets TX signal delay
+ *
+ * RX audio is kept muted while the delayed TX signal is on
+ *
+ * @param Delay in samples, less than DSP_DELAY_SIZE
+ */
+
+void CW_Set_TX_Delay (uint32_t length)
+{
+  cw_mute.length = length;
+}
+
+/**
+ * @brief This function sets TX signal level
+ *
+ * @param Level in Q15
+ */
+
+void CW_Set_TX_Level (int32_t level)
+{
+  cw_route.tx_level = level;
+}
+
+/**
+ * @brief This function sets sidetone level and rise time
+ *
+ * Sidetone may rise faster than TX signal but not slower,
+ * so it is over when TX signal is over
+ *
+ * @param Level in Q15
+ * @param Rise time in ms, 1...CW_ST_RISE_MAX
  */
 
-void CW_Handler (int16_t *i_buffer, int16_t *q_buffer, uint16_t size)
+void CW_Set_Sidetone (int32_t level, uint32_t rise)
 {
-  if (ptt.dtr_is_on || ((cw_keyer.mode == STRAIGHT) && (ptt.key_dah_is_on || ptt.key_dit_is_on)))
+  if (rise < 1U)
   {
-    if (ps.key_state == 0U)   /* Is a CW key up? */
-    {
-      ps.key_state = 3U;      /* It's a rising edge of CW signal */
-    }
+    rise = 1U;
   }
-  else if (ps.key_state)
+
+  if (rise > CW_ST_RISE_MAX)
   {
-      ps.key_state = 1U;      /* It's a falling edge of CW signal */
+    rise = CW_ST_RISE_MAX;
+  }
+
+  cw_route.st_level = level;
+  cw_route.st_step  = (CW_SMOOTH_TBL_SIZE << 8) / (rise * CW_SAMPLES_PER_MS);
+
+  /* Not slower than TX signal */
+  if (cw_route.st_step < (256 / CW_SMOOTH_LEN))
+  {
+    cw_route.st_step = 256 / CW_SMOOTH_LEN;
+  }
+}
+
+/**
+ * @brief This function turns I/Q TX signal on or off
+ *
+ * I/Q TX signal goes to left (I) and right (Q) channels at IF offset,
+ * the sidetone stays at the pitch. Turning it off restores default route.
+ *
+ * @param 1 - on, 0 - off
+ * @param IF offset in Hz, signed
+ * @param 1 - I and Q are swapped
+ */
+
+void CW_Set_IQ (uint8_t is_on, int32_t offset, uint8_t swap)
+{
+  if (offset > CW_IQ_OFFSET_MAX)
+  {
+    offset = CW_IQ_OFFSET_MAX;
+  }
+
+  if (offset < -CW_IQ_OFFSET_MAX)
+  {
+    offset = -CW_IQ_OFFSET_MAX;
+  }
+
+  cw_iq.is_on  = 0U;
+  cw_iq.offset = offset;
+  cw_iq.swap   = swap;
+
+  DDS_Set_TX_Offset (offset, CW_SAMPLES_PER_MS * 1000U);
+
+  if (is_on)
+  {
+    CW_Set_Route (CW_ROUTE_TX_I, CW_ROUTE_TX_Q);
+  }
+  else
+  {
+    CW_Set_Route (CW_ROUTE_SIDETONE, CW_ROUTE_TX_I);
+  }
+
+  cw_iq.is_on = is_on;
+}
+
+/**
+ * @brief This function sets I/Q TX signal imbalance correction
+ *
+ * @param Q amplitude correction in 0.1 %
+ * @param Q phase correction in 0.01 degree
+ */
+
+void CW_Set_IQ_Balance (int32_t amplitude, int32_t phase)
+{
+  float gain  = (1000.0f + (float) amplitude) / 1000.0f;
+  float angle = ((float) phase / 100.0f) * (3.14159265f / 180.0f);
+
+  cw_iq.q_cos = (int32_t) (gain * cosf (angle) * (float) CW_IQ_ONE);
+  cw_iq.q_sin = (int32_t) (gain * sinf (angle) * (float) CW_IQ_ONE);
+}
+
+/**
+ * @brief called every 1000u (== 1000Hz) from I2S IRQ, does cw tone generation
+ *
+ * @param Stereo audio buffer pointer
+ * @param number of samples
+ */
+
+__HOT_FUNC void CW_Handler (int16_t *buffer, uint16_t size)
+{
+  uint8_t key = ptt.dtr_is_on || ptt.tune_is_on
+                || ((cw_keyer.mode == STRAIGHT) && (ptt.key_dah_is_on || ptt.key_dit_is_on));
+
+  cw_block_time = TIME_Get_Us ();
+
+  if (size > (CW_BLOCK_MAX * 2U))
+  {
+    size = CW_BLOCK_MAX * 2U;
   }
 
-  if (ps.key_state)
+  cw_route_clear (buffer, size);
+
+  cw_set_key (key || cw_remote.key_is_on, 0U);
+
+  if (ps.key_state || cw_remote_is_due (size / 2U - 1U))
   {
     for (uint16_t i = 0U; i < size; i += 2U)
     {
-      cw_tone_gen (&i_buffer [i + 0], &i_buffer [i + 1], 1U);
+      /* Remote key events are played with sample accuracy */
+      if (cw_remote_is_due (i / 2U))
+      {
+        cw_remote.key_is_on = cw_remote.buff [cw_remote.rd_ptr & (CW_REMOTE_BUFF_SIZE - 1U)].key;
+        cw_remote.rd_ptr++;
 
-      if (ps.key_state == 0U) /* Is a CW key up? */
+        if (cw_remote.key_is_on)
+        {
+          PTT_Key_On ();
+        }
+
+        cw_set_key (key || cw_remote.key_is_on, i / 2U);
+      }
+
+      if (ps.key_state)
       {
-        PTT_Key_Off_Time ();  /* Set mode to RX with timeout */
-        break;
+        cw_tone_gen (&buffer [i], 1U);
+
+        if (ps.key_state == 0U) /* Is a CW key up? */
+        {
+          PTT_Key_Off_Time ();  /* Set mode to RX with timeout */
+        }
       }
     }
   }
-  else if (cw_keyer.mode < STRAIGHT)
+  else if ((cw_keyer.mode < STRAIGHT) || CW_Text_Pending ())
   {
-    cw_iambic_keyer_handler (i_buffer, q_buffer, size);
+    cw_iambic_keyer_handler (buffer, size);
   }
+
+  cw_rx_mute (buffer, size);
+
+  if (cw_iq.is_on)
+  {
+    cw_iq_correct (buffer, size);
+  }
+
+  cw_sample_clock += size / 2U;
 }
 
 /****END OF FILE****/
@@ -25,11 +25,19 @@
 /* Includes ------------------------------------------------------------------*/
 #include "dds_if.h"
 
+#include <string.h>
+
 /* Private typedef -----------------------------------------------------------*/
 
 /* Private define ------------------------------------------------------------*/
 
-#define DDS_PTR_SHIFT       (32 - DDS_TBL_BITS)
+#define DDS_PTR_SHIFT       (30 - DDS_TBL_BITS)      /* Two upper bits are the quarter */
+#define DDS_FRAC_SHIFT      (DDS_PTR_SHIFT - 15)     /* 15 bits of phase between table points */
+#define DDS_FRAC_MASK       0x7FFF
+#define DDS_MIRROR          0x40000000U              /* 2nd and 4th quarters */
+#define DDS_NEGATIVE        0x80000000U              /* 3rd and 4th quarters */
+#define DDS_SHIFT90         0xC0000000U              /* -90 degree, sin => -cos */
+#define DDS_RECIP_SHIFT     15                       /* Reciprocal is 2^(32 + 15) / sample rate */
 
 /* Private macro -------------------------------------------------------------*/
 
@@ -37,111 +45,41 @@
 
 soft_dds_t dbldds [2]; /* Two Tone DDS */
 soft_dds_t cw_dds;     /* CW Tone DDS  */
+soft_dds_t tx_dds;     /* TX signal DDS at IF offset */
+
+/* Sample rate and its reciprocal to get DDS step by one multiplication */
+static uint32_t dds_sample_rate;
+static uint64_t dds_recip;
 
-/* This table represents 2*PI, i.e. a full sine wave */
-const int16_t DDS_TABLE [DDS_TBL_SIZE] =
+/* This table represents PI/2, i.e. a quarter of sine wave, plus the end point for interpolation */
+__HOT_DATA const int16_t DDS_TABLE [DDS_TBL_SIZE + 1] =
 {
-    0, 201, 402, 603, 804, 1005, 1206,
-    1406, 1607, 1808, 2009, 2209, 2410, 2610, 2811, 3011, 3211, 3411, 3611,
-    3811, 4011, 4210, 4409, 4608, 4807, 5006, 5205, 5403, 5601, 5799, 5997,
-    6195, 6392, 6589, 6786, 6982, 7179, 7375, 7571, 7766, 7961, 8156, 8351,
-    8545, 8739, 8932, 9126, 9319, 9511, 9703, 9895, 10087, 10278, 10469, 10659,
-    10849, 11038, 11227, 11416, 11604, 11792, 11980, 12166, 12353, 12539, 12724,
-    12909, 13094, 13278, 13462, 13645, 13827, 14009, 14191, 14372, 14552, 14732,
-    14911, 15090, 15268, 15446, 15623, 15799, 15975, 16150, 16325, 16499, 16672,
-    16845, 17017, 17189, 17360, 17530, 17699, 17868, 18036, 18204, 18371, 18537,
-    18702, 18867, 19031, 19194, 19357, 19519, 19680, 19840, 20000, 20159, 20317,
-    20474, 20631, 20787, 20942, 21096, 21249, 21402, 21554, 21705, 21855, 22004,
-    22153, 22301, 22448, 22594, 22739, 22883, 23027, 23169, 23311, 23452, 23592,
-    23731, 23869, 24006, 24143, 24278, 24413, 24546, 24679, 24811, 24942, 25072,
-    25201, 25329, 25456, 25582, 25707, 25831, 25954, 26077, 26198, 26318, 26437,
-    26556, 26673, 26789, 26905, 27019, 27132, 27244, 27355, 27466, 27575, 27683,
-    27790, 27896, 28001, 28105, 28208, 28309, 28410, 28510, 28608, 28706, 28802,
-    28897, 28992, 29085, 29177, 29268, 29358, 29446, 29534, 29621, 29706, 29790,
-    29873, 29955, 30036, 30116, 30195, 30272, 30349, 30424, 30498, 30571, 30643,
-    30713, 30783, 30851, 30918, 30984, 31049, 31113, 31175, 31236, 31297, 31356,
-    31413, 31470, 31525, 31580, 31633, 31684, 31735, 31785, 31833, 31880, 31926,
-    31970, 32014, 32056, 32097, 32137, 32176, 32213, 32249, 32284, 32318, 32350,
-    32382, 32412, 32441, 32468, 32495, 32520, 32544, 32567, 32588, 32609, 32628,
-    32646, 32662, 32678, 32692, 32705, 32717, 32727, 32736, 32744, 32751, 32757,
-    32761, 32764, 32766, 32766, 32766, 32764, 32761, 32757, 32751, 32744, 32736,
-    32727, 32717, 32705, 32692, 32678, 32662, 32646, 32628, 32609, 32588, 32567,
-    32544, 32520, 32495, 32468, 32441, 32412, 32382, 32350, 32318, 32284, 32249,
-    32213, 32176, 32137, 32097, 32056, 32014, 31970, 31926, 31880, 31833, 31785,
-    31735, 31684, 31633, 31580, 31525, 31470, 31413, 31356, 31297, 31236, 31175,
-    31113, 31049, 30984, 30918, 30851, 30783, 30713, 30643, 30571, 30498, 30424,
-    30349, 30272, 30195, 30116, 30036, 29955, 29873, 29790, 29706, 29621, 29534,
-    29446, 29358, 29268, 29177, 29085, 28992, 28897, 28802, 28706, 28608, 28510,
-    28410, 28309, 28208, 28105, 28001, 27896, 27790, 27683, 27575, 27466, 27355,
-    27244, 27132, 27019, 26905, 26789, 26673, 26556, 26437, 26318, 26198, 26077,
-    25954, 25831, 25707, 25582, 25456, 25329, 25201, 25072, 24942, 24811, 24679,
-    24546, 24413, 24278, 24143, 24006, 23869, 23731, 23592, 23452, 23311, 23169,
-    23027, 22883, 22739, 22594, 22448, 22301, 22153, 22004, 21855, 21705, 21554,
-    21402, 21249, 21096, 20942, 20787, 20631, 20474, 20317, 20159, 20000, 19840,
-    19680, 19519, 19357, 19194, 19031, 18867, 18702, 18537, 18371, 18204, 18036,
-    17868, 17699, 17530, 17360, 17189, 17017, 16845, 16672, 16499, 16325, 16150,
-    15975, 15799, 15623, 15446, 15268, 15090, 14911, 14732, 14552, 14372, 14191,
-    14009, 13827, 13645, 13462, 13278, 13094, 12909, 12724, 12539, 12353, 12166,
-    11980, 11792, 11604, 11416, 11227, 11038, 10849, 10659, 10469, 10278, 10087,
-    9895, 9703, 9511, 9319, 9126, 8932, 8739, 8545, 8351, 8156, 7961, 7766,
-    7571, 7375, 7179, 6982, 6786, 6589, 6392, 6195, 5997, 5799, 5601, 5403,
-    5205, 5006, 4807, 4608, 4409, 4210, 4011, 3811, 3611, 3411, 3211, 3011,
-    2811, 2610, 2410, 2209, 2009, 1808, 1607, 1406, 1206, 1005, 804, 603, 402,
-    201, 0, -201, -402, -603, -804, -1005, -1206, -1406, -1607, -1808, -2009,
-    -2209, -2410, -2610, -2811, -3011, -3211, -3411, -3611, -3811, -4011, -4210,
-    -4409, -4608, -4807, -5006, -5205, -5403, -5601, -5799, -5997, -6195, -6392,
-    -6589, -6786, -6982, -7179, -7375, -7571, -7766, -7961, -8156, -8351, -8545,
-    -8739, -8932, -9126, -9319, -9511, -9703, -9895, -10087, -10278, -10469,
-    -10659, -10849, -11038, -11227, -11416, -11604, -11792, -11980, -12166,
-    -12353, -12539, -12724, -12909, -13094, -13278, -13462, -13645, -13827,
-    -14009, -14191, -14372, -14552, -14732, -14911, -15090, -15268, -15446,
-    -15623, -15799, -15975, -16150, -16325, -16499, -16672, -16845, -17017,
-    -17189, -17360, -17530, -17699, -17868, -18036, -18204, -18371, -18537,
-    -18702, -18867, -19031, -19194, -19357, -19519, -19680, -19840, -20000,
-    -20159, -20317, -20474, -20631, -20787, -20942, -21096, -21249, -21402,
-    -21554, -21705, -21855, -22004, -22153, -22301, -22448, -22594, -22739,
-    -22883, -23027, -23169, -23311, -23452, -23592, -23731, -23869, -24006,
-    -24143, -24278, -24413, -24546, -24679, -24811, -24942, -25072, -25201,
-    -25329, -25456, -25582, -25707, -25831, -25954, -26077, -26198, -26318,
-    -26437, -26556, -26673, -26789, -26905, -27019, -27132, -27244, -27355,
-    -27466, -27575, -27683, -27790, -27896, -28001, -28105, -28208, -28309,
-    -28410, -28510, -28608, -28706, -28802, -28897, -28992, -29085, -29177,
-    -29268, -29358, -29446, -29534, -29621, -29706, -29790, -29873, -29955,
-    -30036, -30116, -30195, -30272, -30349, -30424, -30498, -30571, -30643,
-    -30713, -30783, -30851, -30918, -30984, -31049, -31113, -31175, -31236,
-    -31297, -31356, -31413, -31470, -31525, -31580, -31633, -31684, -31735,
-    -31785, -31833, -31880, -31926, -31970, -32014, -32056, -32097, -32137,
-    -32176, -32213, -32249, -32284, -32318, -32350, -32382, -32412, -32441,
-    -32468, -32495, -32520, -32544, -32567, -32588, -32609, -32628, -32646,
-    -32662, -32678, -32692, -32705, -32717, -32727, -32736, -32744, -32751,
-    -32757, -32761, -32764, -32766, -32766, -32766, -32764, -32761, -32757,
-    -32751, -32744, -32736, -32727, -32717, -32705, -32692, -32678, -32662,
-    -32646, -32628, -32609, -32588, -32567, -32544, -32520, -32495, -32468,
-    -32441, -32412, -32382, -32350, -32318, -32284, -32249, -32213, -32176,
-    -32137, -32097, -32056, -32014, -31970, -31926, -31880, -31833, -31785,
-    -31735, -31684, -31633, -31580, -31525, -31470, -31413, -31356, -31297,
-    -31236, -31175, -31113, -31049, -30984, -30918, -30851, -30783, -30713,
-    -30643, -30571, -30498, -30424, -30349, -30272, -30195, -30116, -30036,
-    -29955, -29873, -29790, -29706, -29621, -29534, -29446, -29358, -29268,
-    -29177, -29085, -28992, -28897, -28802, -28706, -28608, -28510, -28410,
-    -28309, -28208, -28105, -28001, -27896, -27790, -27683, -27575, -27466,
-    -27355, -27244, -27132, -27019, -26905, -26789, -26673, -26556, -26437,
-    -26318, -26198, -26077, -25954, -25831, -25707, -25582, -25456, -25329,
-    -25201, -25072, -24942, -24811, -24679, -24546, -24413, -24278, -24143,
-    -24006, -23869, -23731, -23592, -23452, -23311, -23169, -23027, -22883,
-    -22739, -22594, -22448, -22301, -22153, -22004, -21855, -21705, -21554,
-    -21402, -21249, -21096, -20942, -20787, -20631, -20474, -20317, -20159,
-    -20000, -19840, -19680, -19519, -19357, -19194, -19031, -18867, -18702,
-    -18537, -18371, -18204, -18036, -17868, -17699, -17530, -17360, -17189,
-    -17017, -16845, -16672, -16499, -16325, -16150, -15975, -15799, -15623,
-    -15446, -15268, -15090, -14911, -14732, -14552, -14372, -14191, -14009,
-    -13827, -13645, -13462, -13278, -13094, -12909, -12724, -12539, -12353,
-    -12166, -11980, -11792, -11604, -11416, -11227, -11038, -10849, -10659,
-    -10469, -10278, -10087, -9895, -9703, -9511, -9319, -9126, -8932, -8739,
-    -8545, -8351, -8156, -7961, -7766, -7571, -7375, -7179, -6982, -6786, -6589,
-    -6392, -6195, -5997, -5799, -5601, -5403, -5205, -5006, -4807, -4608, -4409,
-    -4210, -4011, -3811, -3611, -3411, -3211, -3011, -2811, -2610, -2410, -2209,
-    -2009, -1808, -1607, -1406, -1206, -1005, -804, -603, -402, -201
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809,
+    2009, 2210, 2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811,
+    4011, 4210, 4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800,
+    5998, 6195, 6393, 6590, 6786, 6983, 7179, 7375, 7571, 7767,
+    7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319, 9512, 9704,
+    9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462,
+    13645, 13828, 14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+    15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673, 16846, 17018,
+    17189, 17360, 17530, 17700, 17869, 18037, 18204, 18371, 18537, 18703,
+    18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000, 20159, 20317,
+    20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311,
+    23452, 23592, 23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680,
+    24811, 24942, 25072, 25201, 25329, 25456, 25582, 25708, 25832, 25955,
+    26077, 26198, 26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+    27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001, 28105, 28208,
+    28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037,
+    30117, 30195, 30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783,
+    30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297, 31356, 31414,
+    31470, 31526, 31580, 31633, 31685, 31736, 31785, 31833, 31880, 31926,
+    31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250, 32285, 32318,
+    32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737,
+    32745, 32752, 32757, 32761, 32765, 32766, 32767
 };
 
 
@@ -154,62 +92,76 @@ const int16_t DDS_TABLE [DDS_TBL_SIZE] =
 /* Private functions ---------------------------------------------------------*/
 
 /**
- * Execute a single step in the sinus generation
+ * Get sine value of the phase, 2^32 is 2*PI
+ * The quarter table is mirrored and the value is linear interpolated
+ * between two table points
  */
 
-uint32_t softdds_nextSampleIndex (soft_dds_t *dds)
+__HOT_FUNC int16_t softdds_sin (uint32_t phase)
 {
-  uint32_t retval = dds->ptr >> DDS_PTR_SHIFT;
+  uint32_t k    = (phase >> DDS_PTR_SHIFT) & (DDS_TBL_SIZE - 1);
+  int32_t  frac = (phase >> DDS_FRAC_SHIFT) & DDS_FRAC_MASK;
+  int32_t  a, b;
 
-  if (retval > DDS_TBL_SIZE)
+  if (phase & DDS_MIRROR)
+  {
+    a = DDS_TABLE [DDS_TBL_SIZE - k];
+    b = DDS_TABLE [DDS_TBL_SIZE - k - 1];
+  }
+  else
   {
-    retval -= DDS_TBL_SIZE;
+    a = DDS_TABLE [k];
+    b = DDS_TABLE [k + 1];
   }
 
-  dds->ptr += dds->step;
+  a += ((b - a) * frac) >> 15;
 
-  return retval;
+  return (phase & DDS_NEGATIVE) ? -a : a;
 }
 
-/*
- * Get the index which represents a -90 degree shift compared to
- * k, i.e. get  k = sin(a) => cos(a)
+/**
+ * Execute a single step in the sinus generation and return actual sample value
  */
 
-uint32_t softdds_phase_shift90 (uint32_t k)
+int16_t softdds_nextSample (soft_dds_t *dds_ptr)
 {
-  uint32_t retval = k + (3 * DDS_TBL_SIZE / 4);
+  int16_t retval = softdds_sin (dds_ptr->ptr);
 
-  if (retval > DDS_TBL_SIZE)
-  {
-    retval -= DDS_TBL_SIZE;
-  }
+  dds_ptr->ptr += dds_ptr->step;
 
   return retval;
 }
 
 /**
- * Execute a single step in the sinus generation and return actual sample value
+ * Get DDS step for given frequency and sample rate
+ * The reciprocal of sample rate is taken again only if the rate changes,
+ * so the step is a single 64x32 multiplication. The reciprocal needs more
+ * than 32 bits below 2^15 Hz, the low 64 bits of the product keep the step
+ * exact for any rate
  */
 
-int16_t softdds_nextSample (soft_dds_t *dds_ptr)
+uint32_t softdds_getStep (uint32_t freq, uint32_t sample_rate)
 {
-  int16_t retval = DDS_TABLE [softdds_nextSampleIndex (dds_ptr)];
+  if (sample_rate == 0U) return 0U;
 
-  return retval;
+  if (sample_rate != dds_sample_rate)
+  {
+    dds_recip       = ((1ULL << (32 + DDS_RECIP_SHIFT)) + sample_rate / 2U) / sample_rate;
+    dds_sample_rate = sample_rate;
+  }
+
+  return (uint32_t) ((freq * dds_recip) >> DDS_RECIP_SHIFT);
 }
 
 /**
  * Initialize softdds for given frequency and sample rate
+ * The step is published by a single store, so the function may be called
+ * while the DDS is running in the audio interrupt
  */
 
 void softdds_setFreqDDS (soft_dds_t* dds_ptr, uint32_t freq, uint32_t sample_rate, uint8_t smooth)
 {
-  uint64_t freq64_shifted = freq * DDS_TBL_SIZE;
-
-  freq64_shifted <<= DDS_PTR_SHIFT;
-
-  dds_ptr->step = freq64_shifted / sample_rate;
+  dds_ptr->step = softdds_getStep (freq, sample_rate);
 
   /* Reset accumulator, if need smooth tone transition, do not reset it (e.g. wspr) */
   if (!smooth)
@@ -229,14 +181,16 @@ void softdds_configRunIQ (uint32_t freq [2], uint32_t sample_rate, uint8_t smoot
   softdds_setFreqDDS (&dbldds [1], freq [1], sample_rate, smooth);
 }
 
-void softdds_genIQSingleTone (soft_dds_t* dds, int16_t *i_buff, int16_t *q_buff, uint16_t size)
+__HOT_FUNC void softdds_genIQSingleTone (soft_dds_t* dds, int16_t *i_buff, int16_t *q_buff, uint16_t size)
 {
   for (uint16_t i = 0; i < size; i++)
   {
-    uint32_t k = softdds_nextSampleIndex (dds);      /* Calculate next sample index */
+    uint32_t k = dds->ptr;                           /* Current phase */
+
+    *i_buff = softdds_sin (k);                       /* I value (sin) */
+    *q_buff = softdds_sin (k + DDS_SHIFT90);         /* Q value (cos) */
 
-    *i_buff = DDS_TABLE [k];                         /* Load I value (sin) from DDS table */
-    *q_buff = DDS_TABLE [softdds_phase_shift90 (k)]; /* Load Q value (cos) from DDS table */
+    dds->ptr += dds->step;
 
     i_buff++;
     q_buff++;
@@ -249,20 +203,23 @@ void softdds_genIQSingleTone (soft_dds_t* dds, int16_t *i_buff, int16_t *q_buff,
  * Frequencies need to be configured using softdds_setfreq_dbl
  */
 
-void softdds_genIQTwoTone (soft_dds_t *ddsA, soft_dds_t *ddsB, uint16_t *i_buff, uint16_t *q_buff, uint16_t size)
+void softdds_genIQTwoTone (soft_dds_t *ddsA, soft_dds_t *ddsB, int16_t *i_buff, int16_t *q_buff, uint16_t size)
 {
   for (int i = 0; i < size; i++)
   {
     uint32_t k [2];
 
-    k [0] = softdds_nextSampleIndex (ddsA);                    /* Calculate next sample index */
-    k [1] = softdds_nextSampleIndex (ddsB);
+    k [0] = ddsA->ptr;                                         /* Current phases */
+    k [1] = ddsB->ptr;
 
-    *i_buff = (DDS_TABLE [k [0]] +
-               DDS_TABLE [k [1]]) / 2;                         /* Load I value 0.5 * (sin(a) + sin(b)) */
+    ddsA->ptr += ddsA->step;
+    ddsB->ptr += ddsB->step;
 
-    *q_buff = (DDS_TABLE [softdds_phase_shift90 (k [0])] +
-               DDS_TABLE [softdds_phase_shift90 (k [1])]) / 2; /* Load Q value 0.5 * (cos(a) + cos(b)) */
+    *i_buff = (softdds_sin (k [0]) +
+               softdds_sin (k [1])) / 2;                       /* I value 0.5 * (sin(a) + sin(b)) */
+
+    *q_buff = (softdds_sin (k [0] + DDS_SHIFT90) +
+               softdds_sin (k [1] + DDS_SHIFT90)) / 2;         /* Q value 0.5 * (cos(a) + cos(b)) */
 
     i_buff++;
     q_buff++;
@@ -330,7 +287,7 @@ void softdds_addSingleToneToTwobuffers (soft_dds_t *dds_ptr,
  * Frequency needs to be configured using softdds_setfreq
  */
 
-void softdds_runIQ (uint16_t *i_buff, uint16_t *q_buff, uint16_t size)
+void softdds_runIQ (int16_t *i_buff, int16_t *q_buff, uint16_t size)
 {
   if (dbldds [1].step > 0.0)
   {
@@ -358,7 +315,39 @@ void DDS_Get_Sample (int16_t *buff)
   *buff = softdds_nextSample (&cw_dds);
 }
 
-void DDS_Get_IQ_Sample (int16_t *i_buff, int16_t *q_buff)
+__HOT_FUNC void DDS_Get_IQ_Sample (int16_t *i_buff, int16_t *q_buff)
 {
   softdds_genIQSingleTone (&cw_dds, i_buff, q_buff, 1U);
 }
+
+/**
+ * Negative frequency runs the phase backwards, i.e. Q is inverted
+ */
+
+void DDS_Set_TX_Offset (int32_t freq, uint32_t sample_rate)
+{
+  if (freq < 0)
+  {
+    tx_dds.step = -softdds_getStep (-freq, sample_rate);
+  }
+  else
+  {
+    tx_dds.step = softdds_getStep (freq, sample_rate);
+  }
+}
+
+__HOT_FUNC void DDS_Get_TX_IQ_Sample (int16_t *i_buff, int16_t *q_buff)
+{
+  softdds_genIQSingleTone (&tx_dds, i_buff, q_buff, 1U);
+}
+
+/**
+ * Reset all DDS to zero phase and step, the frequencies are set again after it
+ */
+
+void DDS_Init (void)
+{
+  memset (dbldds,  0, sizeof (dbldds));
+  memset (&cw_dds, 0, sizeof (cw_dds));
+  memset (&tx_dds, 0, sizeof (tx_dds));
+}
@@ -20,6 +20,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "dsp_if.h"
 #include "cw_gen.h"
+#include "prof_if.h"
 
 /* Private typedef -----------------------------------------------------------*/
 
@@ -30,6 +31,8 @@
 /* Private variables ---------------------------------------------------------*/
 
 DSP_Buff_TypeDef dsp_out_buff;
+DSP_Delay_TypeDef dsp_delay;
+DSP_RX_TypeDef dsp_rx;
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -38,6 +41,8 @@ DSP_Buff_TypeDef dsp_out_buff;
 /* External variables --------------------------------------------------------*/
 
 extern CW_Keyer cw_keyer;
+extern CW_Route cw_route;
+extern TRX_TypeDef trx;
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -105,9 +110,11 @@ void DSP_Out_Buff_Mute (void)
  * @param Number of bytes to write
  */
 
-void DSP_In_Buff_Read (uint8_t *pbuf, uint32_t size)
+__HOT_FUNC void DSP_In_Buff_Read (uint8_t *pbuf, uint32_t size)
 {
-  uint16_t *buff = (uint16_t*) pbuf;
+  int16_t *buff = (int16_t*) pbuf;
+
+  PROF_START (PROF_MIX);
 
   size = size / 2U;
 
@@ -128,6 +135,32 @@ void DSP_In_Buff_Read (uint8_t *pbuf, uint32_t size)
     buff [i + 0] = dsp_out_buff.i [dsp_out_buff.rd_ptr];
     buff [i + 1] = dsp_out_buff.q [dsp_out_buff.rd_ptr];
 
+    /* RX audio is ramped in and out on TX/RX switching */
+    if (dsp_rx.gain != DSP_GAIN_MAX || dsp_rx.target != DSP_GAIN_MAX)
+    {
+      if (dsp_rx.gain < dsp_rx.target)
+      {
+        dsp_rx.gain += DSP_RX_RAMP_STEP;
+
+        if (dsp_rx.gain > dsp_rx.target)
+        {
+          dsp_rx.gain = dsp_rx.target;
+        }
+      }
+      else if (dsp_rx.gain > dsp_rx.target)
+      {
+        dsp_rx.gain -= DSP_RX_RAMP_STEP;
+
+        if (dsp_rx.gain < dsp_rx.target)
+        {
+          dsp_rx.gain = dsp_rx.target;
+        }
+      }
+
+      buff [i + 0] = (buff [i + 0] * dsp_rx.gain) >> 15;
+      buff [i + 1] = (buff [i + 1] * dsp_rx.gain) >> 15;
+    }
+
     dsp_out_buff.rd_ptr++;
 
     if (dsp_out_buff.rd_ptr >= DSP_BUFF_SIZE)
@@ -136,7 +169,32 @@ void DSP_In_Buff_Read (uint8_t *pbuf, uint32_t size)
     }
   }
 
-  CW_Handler (pbuf, pbuf, size);
+  PROF_START (PROF_CW);
+  CW_Handler (buff, size);
+  PROF_STOP (PROF_CW);
+
+  /* Channels routed to TX signal are delayed to let PTT lead RF, sidetone is not */
+  if (dsp_delay.length)
+  {
+    for (uint32_t i = 0U; i < size; i += 2U)
+    {
+      uint32_t wr = dsp_delay.wr_ptr & (DSP_DELAY_SIZE - 1U);
+      uint32_t rd = (dsp_delay.wr_ptr - dsp_delay.length) & (DSP_DELAY_SIZE - 1U);
+
+      for (uint8_t ch = 0U; ch < 2U; ch++)
+      {
+        if (cw_route.out [ch] != CW_ROUTE_SIDETONE)
+        {
+          dsp_delay.buff [ch][wr] = buff [i + ch];
+          buff [i + ch] = dsp_delay.buff [ch][rd];
+        }
+      }
+
+      dsp_delay.wr_ptr++;
+    }
+  }
+
+  PROF_STOP (PROF_MIX);
 }
 
 
@@ -147,17 +205,19 @@ void DSP_In_Buff_Read (uint8_t *pbuf, uint32_t size)
 
 void DSP_Set_RX (void)
 {
-
+  dsp_rx.target = DSP_GAIN_MAX;
 }
 
 /**
  * @brief This function sets DSP to TX mode
  *
+ * With full break-in RX audio is muted by CW generator
+ * during elements only
  */
 
-void DSP_Set_TX (void)
+__HOT_FUNC void DSP_Set_TX (void)
 {
-
+  dsp_rx.target = dsp_rx.qsk ? DSP_GAIN_MAX : 0;
 }
 
 /**
@@ -170,6 +230,40 @@ void DSP_Set_Mode (uint8_t mode)
 
 }
 
+/**
+ * @brief This function sets TX signal delay
+ *
+ * @param Delay in samples, 0 - no delay
+ */
+
+void DSP_Set_Delay (uint32_t length)
+{
+  if (length >= DSP_DELAY_SIZE)
+  {
+    length = DSP_DELAY_SIZE - 1U;
+  }
+
+  dsp_delay.length = length;
+
+  CW_Set_TX_Delay (length);
+}
+
+/**
+ * @brief This function turns full break-in on or off
+ *
+ * @param 1 - RX audio between elements, 0 - RX audio is muted during TX
+ */
+
+void DSP_Set_QSK (uint8_t qsk)
+{
+  dsp_rx.qsk = qsk;
+
+  if (trx.is_tx)
+  {
+    DSP_Set_TX ();
+  }
+}
+
 /**
  * @brief This function initialize DSP and CW generator
  *
@@ -177,13 +271,26 @@ void DSP_Set_Mode (uint8_t mode)
 
 void DSP_Init (void)
 {
-  cw_keyer.pitch = 7U;
+  CW_Init ();
+
+  cw_keyer.pitch = CW_PITCH_DEFAULT;
   cw_keyer.speed = 14U;
 
   cw_keyer.mode  = IAMBIC_B;
 
   CW_Set_Keyer ();
-  CW_Set_Pitch (cw_keyer.pitch * 100U, USBD_AUDIO_FREQ);
+  CW_Set_Pitch (cw_keyer.pitch, USBD_AUDIO_FREQ);
+  CW_Remote_Set_Delay (CW_REMOTE_DELAY);
+
+  CW_Set_Route (CW_ROUTE_SIDETONE, CW_ROUTE_TX_I);
+  CW_Set_TX_Level (CW_TX_LEVEL);
+  CW_Set_Sidetone (CW_ST_LEVEL, CW_ST_RISE);
+  CW_Set_IQ_Balance (0, 0);
+  CW_Set_TX_Delay (dsp_delay.length);
+
+  dsp_rx.gain   = DSP_GAIN_MAX;
+  dsp_rx.target = DSP_GAIN_MAX;
+  dsp_rx.qsk    = 1U;
 
   DSP_Out_Buff_Mute ();
   dsp_out_buff.wr_ptr = 0U;
@@ -0,0 +1,177 @@
+/**
+  *******************************************************************************
+  *
+  * @file    evt_if.c
+  * @brief   Paddle and Key Event Export
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  *
+  * Paddle and keyer output edges are recorded by interrupt handlers
+  * and sent to the host from the main loop in batches. A batch is up to
+  * 60 bytes, so it fits one 64 byte USB packet, and it is queued whole
+  * or not at all: the host never gets a record cut in two.
+  *
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "evt_if.h"
+#include "usbd_cdc_if.h"
+#include "time_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+EVT_TypeDef evt;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function records an event
+ *
+ * It may be called from any interrupt handler
+ *
+ * @param Record type
+ */
+
+void EVT_Put (uint8_t type)
+{
+  EVT_Put_Time (type, TIME_Get_Us ());
+}
+
+/**
+ * @brief This function records an event which happened at a given time
+ *
+ * The keyer renders a block of samples at once, its edges are
+ * timed by the sample offset in the block
+ *
+ * @param Record type
+ * @param Event time, us
+ */
+
+__HOT_FUNC void EVT_Put_Time (uint8_t type, uint32_t time)
+{
+  uint32_t primask;
+
+  if (!evt.export) return;
+
+  primask = __get_PRIMASK ();
+  __disable_irq ();
+
+  if ((evt.wr_ptr - evt.rd_ptr) < EVT_BUFF_SIZE)
+  {
+    evt.buff [evt.wr_ptr & (EVT_BUFF_SIZE - 1U)].time = time;
+    evt.buff [evt.wr_ptr & (EVT_BUFF_SIZE - 1U)].type = type;
+    evt.wr_ptr++;
+  }
+  else
+  {
+    evt.overflows++;
+  }
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function turns event export on or off
+ *
+ */
+
+void EVT_Set_Export (uint8_t export)
+{
+  evt.export = export;
+}
+
+/**
+ * @brief This function initialize event export
+ *
+ */
+
+void EVT_Init (void)
+{
+  evt.export     = 0U;
+  evt.wr_ptr     = 0U;
+  evt.rd_ptr     = 0U;
+  evt.batch_open = 0U;
+  evt.overflows  = 0U;
+}
+
+/**
+ * @brief This function sends recorded events to the host
+ *
+ * Records are sent when a batch is full or the oldest record has waited
+ * for EVT_TIMEOUT. A batch the CDC ring has no room for is kept and sent
+ * again on the next call. It is called from the main loop
+ *
+ */
+
+void EVT_Handler (void)
+{
+  uint8_t  packet [EVT_BATCH * EVT_RECORD_SIZE];
+  uint8_t  *p = packet;
+  uint32_t pending = evt.wr_ptr - evt.rd_ptr;
+  EVT_Record_TypeDef *record;
+  uint32_t time;
+
+  if (pending == 0U) return;
+
+  if (!evt.batch_open)
+  {
+    evt.batch_open  = 1U;
+    evt.batch_start = TIME_Get_Us ();
+  }
+
+  if ((pending < EVT_BATCH) && ((TIME_Get_Us () - evt.batch_start) < (EVT_TIMEOUT * 1000U))) return;
+
+  if (pending > EVT_BATCH)
+  {
+    pending = EVT_BATCH;
+  }
+
+  for (uint32_t i = 0U; i < pending; i++)
+  {
+    record = &evt.buff [(evt.rd_ptr + i) & (EVT_BUFF_SIZE - 1U)];
+    time   = record->time;
+
+    *p++ = EVT_SYNC;
+    *p++ = record->type;
+    *p++ = (uint8_t) (time);
+    *p++ = (uint8_t) (time >> 8U);
+    *p++ = (uint8_t) (time >> 16U);
+    *p++ = (uint8_t) (time >> 24U);
+  }
+
+  /* The records are freed only when the whole batch is queued */
+  if (CDC_Transmit_FS (packet, pending * EVT_RECORD_SIZE) != USBD_OK)
+  {
+    evt.overflows++;
+    return;
+  }
+
+  evt.rd_ptr    += pending;
+  evt.batch_open = 0U;
+}
+
+/****END OF FILE****/
@@ -0,0 +1,305 @@
+/**
+  *******************************************************************************
+  *
+  * @file    lp_if.c
+  * @brief   Low power idle and USB suspend
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  *
+  * When no main loop task is due the core sleeps in WFI, the sleep time
+  * gives the idle ratio and the supply current estimate of each window.
+  *
+  * While the USB bus is suspended the core goes to STOP mode with the
+  * display off, the ADC disabled and the USB PHY clock gated. It is woken
+  * by the bus resume on the OTG FS wake up EXTI line or by the paddles.
+  * Before each STOP entry the transmitter is put to a safe state: keying
+  * stops, RX is set and the sequencer outputs are released, as the timer
+  * driving them stops too. The clocks are restored before any interrupt
+  * handler runs. The timers stop in STOP mode, so the STOP time is not
+  * counted in the windows.
+  *
+  * The results are read by CAT command ZL, see cat_if.c.
+  *
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "lp_if.h"
+#include "time_if.h"
+#include "ptt_if.h"
+#include "seq_if.h"
+#include "cw_gen.h"
+#include "ssd1306.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+LP_TypeDef lp;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+extern ADC_HandleTypeDef hadc1;
+extern PCD_HandleTypeDef hpcd_USB_OTG_FS;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function latches the idle ratio at the window end
+ *
+ */
+
+static void lp_window (void)
+{
+  uint32_t elapsed = TIME_Get_Us () - lp.window_start;
+
+  if (elapsed < (LP_WINDOW * 1000U)) return;
+
+  lp.idle    = (uint32_t) (((uint64_t) lp.idle_run * 1000U) / elapsed);
+  lp.current_est = (LP_RUN_CURRENT * (1000U - lp.idle) + LP_SLEEP_CURRENT * lp.idle) / 1000U;
+
+  lp.idle_run     = 0U;
+  lp.window_start += elapsed;
+}
+
+/**
+ * @brief This function restores the clocks after STOP mode
+ *
+ * The core runs from HSI until SYSCLK is switched to the PLL, so the
+ * DWT cycles are counted at HSI up to the switch and at the PLL after it.
+ * The setup is kept from SystemClock_Config (), only HSE, the PLL and the
+ * SYSCLK source are turned back on
+ *
+ * @retval Restore time, us
+ */
+
+static uint32_t lp_clock_restore (void)
+{
+  RCC_OscInitTypeDef osc = {0};
+  RCC_ClkInitTypeDef clk = {0};
+  uint32_t latency;
+  uint32_t start = DWT->CYCCNT;
+  uint32_t hsi;
+
+  HAL_RCC_GetOscConfig (&osc);
+
+  osc.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+  osc.HSEState       = RCC_HSE_ON;
+  osc.PLL.PLLState   = RCC_PLL_ON;
+
+  if (HAL_RCC_OscConfig (&osc) != HAL_OK)
+  {
+    Error_Handler ();
+  }
+
+  HAL_RCC_GetClockConfig (&clk, &latency);
+
+  clk.ClockType    = RCC_CLOCKTYPE_SYSCLK;
+  clk.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+
+  hsi   = DWT->CYCCNT - start;
+  start = DWT->CYCCNT;
+
+  if (HAL_RCC_ClockConfig (&clk, latency) != HAL_OK)
+  {
+    Error_Handler ();
+  }
+
+  return hsi / (HSI_VALUE / 1000000U) + (DWT->CYCCNT - start) / (SystemCoreClock / 1000000U);
+}
+
+/**
+ * @brief This function stops the core while USB is suspended
+ *
+ * It is called with interrupts masked, so the handler of the wake up
+ * interrupt runs after the clocks are restored. It is called again after
+ * a paddle wake up while USB stays suspended, so the safe state is set
+ * before each STOP entry
+ *
+ */
+
+static void lp_stop (void)
+{
+  /* Key out, PTT lines and TX must not stay on while the timers stop */
+  CW_Key_Off ();
+  PTT_Force_RX ();
+  SEQ_Idle ();
+
+  ssd1306_SetDisplayOn (0U);
+
+  /* The ADC is powered in STOP mode unless disabled, UI_Handler () enables it */
+  __HAL_ADC_DISABLE (&hadc1);
+
+  __HAL_USB_OTG_FS_WAKEUP_EXTI_CLEAR_FLAG ();
+
+  lp.stops++;
+
+  HAL_SuspendTick ();
+  HAL_PWR_EnterSTOPMode (PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+  lp.resume = lp_clock_restore ();
+  HAL_ResumeTick ();
+
+  if (lp.resume > lp.resume_max) lp.resume_max = lp.resume;
+
+  /* Resume or reset signalling on the bus, a paddle leaves USB suspended */
+  if (__HAL_USB_OTG_FS_WAKEUP_EXTI_GET_FLAG ())
+  {
+    __HAL_PCD_UNGATE_PHYCLOCK (&hpcd_USB_OTG_FS);
+    lp.suspended = 0U;
+  }
+
+  if (!lp.suspended)
+  {
+    ssd1306_SetDisplayOn (1U);
+  }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function sleeps until an interrupt
+ *
+ * It is called by the scheduler with interrupts masked
+ *
+ */
+
+void LP_Sleep (void)
+{
+  uint32_t start;
+
+  if (lp.suspended)
+  {
+    lp_stop ();
+    return;
+  }
+
+  start = TIME_Get_Us ();
+
+  __WFI ();
+
+  lp.idle_run += TIME_Get_Us () - start;
+
+  lp_window ();
+}
+
+/**
+ * @brief This function is called on USB suspend
+ *
+ * The PHY clock is gated already, STOP mode is entered by the main loop
+ *
+ */
+
+void LP_Suspend (void)
+{
+  lp.suspended = 1U;
+  lp.suspends++;
+}
+
+/**
+ * @brief This function is called on USB resume
+ *
+ */
+
+void LP_Resume (void)
+{
+  lp.suspended = 0U;
+}
+
+/**
+ * @brief This function clears the counters
+ *
+ */
+
+void LP_Reset (void)
+{
+  lp.suspends   = 0U;
+  lp.stops      = 0U;
+  lp.resume_max = 0U;
+}
+
+/**
+ * @brief This function formats the power state as CAT answer
+ *
+ * ZL idle,est current,suspends,stops,resume,resume max;
+ *
+ * Idle is in 0.1% of the last window, times in us. The current in uA is
+ * not measured, it is estimated from the idle ratio with LP_RUN_CURRENT
+ * and LP_SLEEP_CURRENT
+ *
+ * @param Answer buffer
+ * @param Buffer size
+ * @retval Answer length
+ */
+
+uint32_t LP_Format (char *buff, uint32_t size)
+{
+  lp_window ();
+
+  return snprintf (buff, size, "ZL%lu,%lu,%lu,%lu,%lu,%lu;",
+                   (unsigned long) lp.idle,
+                   (unsigned long) lp.current_est,
+                   (unsigned long) lp.suspends,
+                   (unsigned long) lp.stops,
+                   (unsigned long) lp.resume,
+                   (unsigned long) lp.resume_max);
+}
+
+/**
+ * @brief This function sets up low power modes
+ *
+ * The clocks not needed while the core sleeps are gated in Sleep mode
+ *
+ */
+
+void LP_Init (void)
+{
+  memset (&lp, 0, sizeof (lp));
+
+  lp.window_start = TIME_Get_Us ();
+  lp.current_est  = LP_RUN_CURRENT;
+
+  /* PH0/PH1 are HSE pins, they do not need the port clock */
+  __HAL_RCC_GPIOH_CLK_DISABLE ();
+
+  /* The flash, the display bus and EXTI configuration are used by the core only */
+  __HAL_RCC_FLITF_CLK_SLEEP_DISABLE ();
+  __HAL_RCC_I2C2_CLK_SLEEP_DISABLE ();
+  __HAL_RCC_SYSCFG_CLK_SLEEP_DISABLE ();
+
+  HAL_PWREx_EnableFlashPowerDown ();
+
+  __HAL_USB_OTG_FS_WAKEUP_EXTI_ENABLE_RISING_EDGE ();
+  __HAL_USB_OTG_FS_WAKEUP_EXTI_ENABLE_IT ();
+
+  HAL_NVIC_SetPriority (OTG_FS_WKUP_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ (OTG_FS_WKUP_IRQn);
+
+#ifdef DEBUG
+  /* Keep the debugger connected in Sleep and STOP modes */
+  HAL_DBGMCU_EnableDBGSleepMode ();
+  HAL_DBGMCU_EnableDBGStopMode ();
+#endif
+}
+
+/****END OF FILE****/
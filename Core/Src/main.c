@@ -24,9 +24,18 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 
+#include "time_if.h"
 #include "ptt_if.h"
+#include "cat_if.h"
+#include "wk_if.h"
+#include "evt_if.h"
+#include "seq_if.h"
 #include "user_if.h"
 #include "usbd_cdc_if.h"
+#include "prof_if.h"
+#include "mon_if.h"
+#include "sched_if.h"
+#include "lp_if.h"
 
 /* USER CODE END Includes */
 
@@ -48,6 +57,7 @@ ADC_HandleTypeDef hadc1;
 
 I2C_HandleTypeDef hi2c2;
 
+TIM_HandleTypeDef htim2;
 TIM_HandleTypeDef htim3;
 
 /* USER CODE BEGIN PV */
@@ -62,6 +72,7 @@ static void MX_GPIO_Init(void);
 static void MX_ADC1_Init(void);
 static void MX_I2C2_Init(void);
 static void MX_TIM3_Init(void);
+static void MX_TIM2_Init(void);
 /* USER CODE BEGIN PFP */
 
 /* USER CODE END PFP */
@@ -103,13 +114,28 @@ int main(void)
   MX_ADC1_Init();
   MX_I2C2_Init();
   MX_TIM3_Init();
+  MX_TIM2_Init();
   /* USER CODE BEGIN 2 */
 
-  trx.sysclock = 0U;
-  trx.systicks = 10U;
-
+  TIME_Init ();
+  PROF_Init ();
+  MON_Init ();
+  SEQ_Init ();
   UI_Init ();
   PTT_Init ();
+  CAT_Init ();
+  WK_Init ();
+  EVT_Init ();
+  SCHED_Init ();
+  LP_Init ();
+
+  /* Period and deadline in ms, CAT runs on CDC data only */
+  SCHED_Add (SCHED_PTT, "PTT", PTT_Handler,    1U,             1U);
+  SCHED_Add (SCHED_CAT, "CAT", CAT_Handler,    0U,             2U);
+  SCHED_Add (SCHED_CDC, "CDC", CDC_Handler_FS, 1U,             1U);
+  SCHED_Add (SCHED_WK,  "WK",  WK_Handler,     1U,             2U);
+  SCHED_Add (SCHED_EVT, "EVT", EVT_Handler,    1U,             2U);
+  SCHED_Add (SCHED_UI,  "UI",  UI_Handler,     UI_REDRAW_TIME, UI_REDRAW_TIME);
 
   /* USER CODE END 2 */
 
@@ -117,8 +143,8 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-    PTT_Handler ();
-    UI_Handler ();
+    MON_Loop ();
+    SCHED_Run ();
 
     /* USER CODE END WHILE */
 
@@ -307,6 +333,73 @@ static void MX_TIM3_Init(void)
 
 }
 
+/**
+  * @brief TIM2 Initialization Function
+  * @param None
+  * @retval None
+  */
+static void MX_TIM2_Init(void)
+{
+
+  /* USER CODE BEGIN TIM2_Init 0 */
+
+  /* USER CODE END TIM2_Init 0 */
+
+  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+  TIM_OC_InitTypeDef sConfigOC = {0};
+
+  /* USER CODE BEGIN TIM2_Init 1 */
+
+  /* USER CODE END TIM2_Init 1 */
+  htim2.Instance = TIM2;
+  htim2.Init.Prescaler = 95;
+  htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim2.Init.Period = 4294967295;
+  htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
+  if (HAL_TIM_ConfigClockSource(&htim2, &sClockSourceConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  if (HAL_TIM_OC_Init(&htim2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim2, &sMasterConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfigOC.OCMode = TIM_OCMODE_TIMING;
+  sConfigOC.Pulse = 0;
+  sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+  sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+  if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_3) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN TIM2_Init 2 */
+
+  /* USER CODE END TIM2_Init 2 */
+  HAL_TIM_MspPostInit(&htim2);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -0,0 +1,266 @@
+/**
+  *******************************************************************************
+  *
+  * @file    mon_if.c
+  * @brief   Interrupt latency and CPU load monitor
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  *
+  * Interrupt entry latency is taken from SysTick: its counter shows how
+  * many cycles ago the interrupt was requested. The handlers are timed by
+  * the DWT cycle counter, the share of cycles spent in them is the load.
+  * The longest main loop pass is watched too, the time the main loop
+  * sleeps in WFI is left out of it. The audio render runs in PendSV with a budget of
+  * its own, a packet sent before it was rendered raises an alarm at once.
+  *
+  * Every MON_WINDOW ms the results are latched and checked against the
+  * budgets of the 1 ms audio frame. They are read by CAT command ZM and
+  * shown on the display.
+  *
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mon_if.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+MON_TypeDef mon;
+
+static __IO uint32_t mon_window;    /* Windows counter, SysTick side */
+static uint32_t      mon_loop_window;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function latches the window results and checks the budgets
+ *
+ */
+
+static void mon_window_end (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint32_t alarm   = 0U;
+  uint32_t now;
+  uint32_t busy;
+
+  __disable_irq ();
+
+  now = DWT->CYCCNT;
+
+  /* A handler preempted by SysTick is still open, its time up to now
+   * belongs to this window and the rest to the next one */
+  if (mon.depth)
+  {
+    mon.busy      += now - mon.busy_start;
+    mon.busy_start = now;
+  }
+
+  busy     = mon.busy;
+  mon.busy = 0U;
+
+  __set_PRIMASK (primask);
+
+  mon.load = (uint32_t) (((uint64_t) busy * 1000U) / ((uint64_t) mon.ticks * mon.frame));
+
+  if (mon.load > mon.load_max) mon.load_max = mon.load;
+
+  if (mon.load > (MON_LOAD_LIMIT * 1000U) / 256U)
+  {
+    alarm |= MON_ALARM_LOAD;
+  }
+
+  mon.latency     = mon.latency_run;
+  mon.latency_run = 0U;
+
+  if (mon.latency > (mon.frame * MON_LATENCY_LIMIT) / 256U)
+  {
+    alarm |= MON_ALARM_LATENCY;
+  }
+
+  for (uint32_t i = 0U; i < MON_ISR_NUM; i++)
+  {
+    MON_ISR_TypeDef *s = &mon.isr [i];
+
+    s->window_max = s->run_max;
+    s->run_max    = 0U;
+
+    if (s->window_max > s->max) s->max = s->window_max;
+
+    if (s->window_max > (mon.frame * ((i == MON_RENDER) ? MON_RENDER_LIMIT : MON_ISR_LIMIT)) / 256U)
+    {
+      alarm |= MON_ALARM_ISR;
+    }
+  }
+
+  if (alarm)
+  {
+    mon.alarm |= alarm;
+    mon.alarms++;
+  }
+
+  mon.ticks = 0U;
+
+  mon_window++;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function measures SysTick entry latency
+ *
+ * It must be the first thing SysTick_Handler does
+ *
+ */
+
+void MON_Tick (void)
+{
+  uint32_t latency = SysTick->LOAD - SysTick->VAL;
+
+  /* SysTick runs before MON_Init () */
+  if (mon.frame == 0U) return;
+
+  if (latency > mon.latency_run) mon.latency_run = latency;
+  if (latency > mon.latency_max) mon.latency_max = latency;
+
+  if (++mon.ticks >= MON_WINDOW)
+  {
+    mon_window_end ();
+  }
+}
+
+/**
+ * @brief This function is called on every main loop pass
+ *
+ */
+
+void MON_Loop (void)
+{
+  uint32_t now  = DWT->CYCCNT;
+  uint32_t pass = now - mon.loop_start;
+
+  mon.loop_start = now;
+
+  /* The main loop latches its own results, SysTick only starts a window */
+  if (mon_loop_window != mon_window)
+  {
+    mon_loop_window = mon_window;
+    mon.loop      = mon.loop_run;
+    mon.loops     = mon.loops_run;
+    mon.loop_run  = 0U;
+    mon.loops_run = 0U;
+  }
+
+  if (pass > mon.loop_run) mon.loop_run = pass;
+
+  mon.loops_run++;
+}
+
+/**
+ * @brief This function clears the maxima and the alarms
+ *
+ */
+
+void MON_Reset (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+
+  __disable_irq ();
+
+  for (uint32_t i = 0U; i < MON_ISR_NUM; i++)
+  {
+    mon.isr [i].max   = 0U;
+    mon.isr [i].count = 0U;
+  }
+
+  mon.latency_max = 0U;
+  mon.load_max    = 0U;
+  mon.overruns    = 0U;
+  mon.alarm       = 0U;
+  mon.alarms      = 0U;
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function formats the monitor state as CAT answer
+ *
+ * ZM frame,load,load max,latency,latency max,loop,loops,
+ *    USB,EXTI,TIM,ADC,SysTick,render longest runs,overruns,alarm;
+ *
+ * Times are in cycles, loads in 0.1%, loops per window
+ *
+ * @param Answer buffer
+ * @param Buffer size
+ * @retval Answer length
+ */
+
+uint32_t MON_Format (char *buff, uint32_t size)
+{
+  uint32_t primask = __get_PRIMASK ();
+  MON_TypeDef m;
+
+  /* Interrupt handlers update the state, take a consistent copy */
+  __disable_irq ();
+  m = mon;
+  __set_PRIMASK (primask);
+
+  return snprintf (buff, size, "ZM%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu;",
+                   (unsigned long) m.frame,
+                   (unsigned long) m.load,
+                   (unsigned long) m.load_max,
+                   (unsigned long) m.latency,
+                   (unsigned long) m.latency_max,
+                   (unsigned long) m.loop,
+                   (unsigned long) m.loops,
+                   (unsigned long) m.isr [MON_USB].max,
+                   (unsigned long) m.isr [MON_EXTI].max,
+                   (unsigned long) m.isr [MON_TIM].max,
+                   (unsigned long) m.isr [MON_ADC].max,
+                   (unsigned long) m.isr [MON_TICK].max,
+                   (unsigned long) m.isr [MON_RENDER].max,
+                   (unsigned long) m.overruns,
+                   (unsigned long) m.alarm);
+}
+
+/**
+ * @brief This function starts the monitor
+ *
+ */
+
+void MON_Init (void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  memset (&mon, 0, sizeof (mon));
+
+  mon.frame      = SysTick->LOAD + 1U;
+  mon.loop_start = DWT->CYCCNT;
+}
+
+/****END OF FILE****/
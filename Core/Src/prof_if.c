@@ -0,0 +1,141 @@
+/**
+  *******************************************************************************
+  *
+  * @file    prof_if.c
+  * @brief   Cycle count profiler
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  *
+  * Named zones are timed by the DWT cycle counter. Each zone keeps count,
+  * min, max, sum and a log2 histogram of its run times in cycles. The
+  * statistics are read by CAT command ZP, see cat_if.c.
+  *
+  * Without PROF_ENABLE the zone macros are empty and nothing is built.
+  *
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "prof_if.h"
+
+#if PROF_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+PROF_TypeDef prof;
+
+static const char *prof_names [PROF_ZONES] =
+{
+  "USB", "MIX", "CW", "EXTI", "UI", "DISP"
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function clears the zone statistics
+ *
+ */
+
+void PROF_Reset (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+
+  __disable_irq ();
+
+  memset (&prof, 0, sizeof (prof));
+
+  for (uint32_t i = 0U; i < PROF_ZONES; i++)
+  {
+    prof.zone [i].min = 0xFFFFFFFFU;
+  }
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function formats a zone as CAT answer
+ *
+ * ZPn,name,count,min,max,mean,hist0,...,hist15; with times in cycles
+ *
+ * @param Zone
+ * @param Answer buffer
+ * @param Buffer size, PROF_LINE_SIZE is enough
+ * @retval Answer length, 0 if the zone does not exist
+ */
+
+uint32_t PROF_Format (uint8_t n, char *buff, uint32_t size)
+{
+  uint32_t primask = __get_PRIMASK ();
+  PROF_Zone_TypeDef z;
+  uint32_t len;
+
+  if (n >= PROF_ZONES) return 0U;
+
+  /* Interrupt handlers update the zones, take a consistent copy */
+  __disable_irq ();
+  z = prof.zone [n];
+  __set_PRIMASK (primask);
+
+  len = snprintf (buff, size, "ZP%u,%s,%lu,%lu,%lu,%lu", (unsigned int) n, prof_names [n],
+                  (unsigned long) z.count,
+                  (unsigned long) (z.count ? z.min : 0U),
+                  (unsigned long) z.max,
+                  (unsigned long) (z.count ? z.sum / z.count : 0U));
+
+  for (uint32_t i = 0U; (i < PROF_HIST_BINS) && (len < size); i++)
+  {
+    len += snprintf (&buff [len], size - len, ",%lu", (unsigned long) z.hist [i]);
+  }
+
+  if (len + 1U < size)
+  {
+    buff [len++] = ';';
+    buff [len]   = '\0';
+  }
+
+  return len;
+}
+
+/**
+ * @brief This function starts the cycle counter
+ *
+ */
+
+void PROF_Init (void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+  PROF_Reset ();
+}
+
+#endif /* PROF_ENABLE */
+
+/****END OF FILE****/
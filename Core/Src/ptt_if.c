@@ -21,6 +21,9 @@
 #include "main.h"
 #include "dsp_if.h"
 #include "ptt_if.h"
+#include "time_if.h"
+#include "seq_if.h"
+#include "evt_if.h"
 
 /* Private typedef -----------------------------------------------------------*/
 
@@ -31,6 +34,7 @@
 /* Private variables ---------------------------------------------------------*/
 
 PTT_TypeDef ptt;
+VFO_TypeDef vfo;
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -50,14 +54,16 @@ extern TRX_TypeDef trx;
   *
   */
 
-void ptt_set_tx (void)
+__HOT_FUNC void ptt_set_tx (void)
 {
-  ptt.key_off_time = 0U;
+  ptt.key_off_is_on = 0U;
 
   if (!trx.is_tx)
   {
     trx.is_tx = 1U;
-    HAL_GPIO_WritePin (TX_GPIO_Port, TX_Pin, GPIO_PIN_RESET);
+    TX_GPIO_Port->BSRR = (uint32_t) TX_Pin << 16U;   /* Reset, no HAL call from RAM */
+    SEQ_PTT (1U);
+    DSP_Set_TX ();
   }
 }
 
@@ -73,15 +79,131 @@ void ptt_set_tx (void)
 void ptt_set_rx (void)
 {
   if (ptt.key_dah_is_on || ptt.key_dit_is_on
-      || ptt.dtr_is_on || ptt.rts_is_on) return;
+      || ptt.dtr_is_on || ptt.rts_is_on || ptt.cat_is_on
+      || ptt.tune_is_on) return;
 
   if (trx.is_tx)
   {
     trx.is_tx = 0U;
     HAL_GPIO_WritePin (TX_GPIO_Port, TX_Pin, GPIO_PIN_SET);
+    SEQ_PTT (0U);
+    DSP_Set_RX ();
   }
 }
 
+/**
+  * @brief This function takes a paddle edge
+  *
+  * An edge within PTT_DEBOUNCE_TIME of the last accepted one is contact
+  * bounce and is ignored, PTT_Handler () reads the paddle again when the
+  * lockout is over. It must be called with the EXTI interrupts masked or
+  * from their handler
+  *
+  * @param PTT_DAH or PTT_DIT
+  */
+
+static void ptt_paddle (uint8_t paddle)
+{
+  uint8_t  *is_on = (paddle == PTT_DAH) ? &ptt.key_dah_is_on : &ptt.key_dit_is_on;
+  uint32_t *time  = (paddle == PTT_DAH) ? &ptt.key_dah_time  : &ptt.key_dit_time;
+  uint32_t now    = TIME_Get_Us ();
+  uint8_t  key_is_on;
+
+  if (paddle == PTT_DAH)
+  {
+    key_is_on = !HAL_GPIO_ReadPin (KEY_DAH_GPIO_Port, KEY_DAH_Pin);
+  }
+  else
+  {
+    key_is_on = !HAL_GPIO_ReadPin (KEY_DIT_GPIO_Port, KEY_DIT_Pin);
+  }
+
+  if (*is_on == key_is_on) return;
+
+  if ((now - *time) < (PTT_DEBOUNCE_TIME * 1000U))
+  {
+    ptt.key_bounce |= paddle;
+    return;
+  }
+
+  *time  = now;
+  *is_on = key_is_on;
+
+  if (paddle == PTT_DAH)
+  {
+    EVT_Put (key_is_on ? EVT_DAH_DOWN : EVT_DAH_UP);
+  }
+  else
+  {
+    EVT_Put (key_is_on ? EVT_DIT_DOWN : EVT_DIT_UP);
+  }
+
+  if (key_is_on)
+  {
+    ptt_set_tx ();
+  }
+}
+
+/**
+  * @brief This function sets RX mode whatever holds TX
+  *
+  * The paddles, CAT, DTR, RTS and tune requests and the hang time are
+  * dropped. It is called before the core stops, a paddle held meanwhile
+  * keys again when it is pressed again
+  *
+  */
+
+void PTT_Force_RX (void)
+{
+  ptt.dtr_is_on     = 0U;
+  ptt.rts_is_on     = 0U;
+  ptt.cat_is_on     = 0U;
+  ptt.tune_is_on    = 0U;
+  ptt.key_dah_is_on = 0U;
+  ptt.key_dit_is_on = 0U;
+  ptt.key_bounce    = 0U;
+  ptt.key_off_is_on = 0U;
+
+  trx.is_tx = 0U;
+  HAL_GPIO_WritePin (TX_GPIO_Port, TX_Pin, GPIO_PIN_SET);
+  DSP_Set_RX ();
+}
+
+/**
+  * @brief This function sets TX mode from CAT command
+  *
+  */
+
+void PTT_CAT_TX (uint8_t cat)
+{
+  if (ptt.cat_is_on != cat)
+  {
+    ptt.cat_is_on = cat;
+
+    if (cat)
+    {
+      ptt_set_tx ();
+    }
+    else
+    {
+      ptt_set_rx ();
+    }
+  }
+}
+
+/**
+  * @brief This function sets TRX mode
+  *
+  * @param Mode number as used by Kenwood CAT
+  *
+  */
+
+void PTT_Set_Mode (uint8_t mode)
+{
+  trx.mode = mode;
+  DSP_Set_Mode (mode);
+}
+
 /**
   * @brief This function sets TX mode from DTR line
   *
@@ -102,6 +224,26 @@ void PTT_DTR_TX (uint8_t dtr)
   }
 }
 
+/**
+  * @brief This function sets TX mode for continuous carrier
+  *
+  * Tune works like DTR line: RX mode is set after the key timeout
+  *
+  */
+
+void PTT_Tune_TX (uint8_t tune)
+{
+  if (ptt.tune_is_on != tune)
+  {
+    ptt.tune_is_on = tune;
+
+    if (tune)
+    {
+      ptt_set_tx ();
+    }
+  }
+}
+
 /**
   * @brief This function sets TX mode from RTS line
   *
@@ -126,14 +268,158 @@ void PTT_RTS_TX (uint8_t rts)
   }
 }
 
+/**
+  * @brief This function sets TX mode for the built-in CW encoder
+  *
+  * RX mode is set after the hang time by PTT_Key_Off_Time ()
+  *
+  */
+
+__HOT_FUNC void PTT_Key_On (void)
+{
+  ptt_set_tx ();
+}
+
 /**
   * @brief This function sets telegraph key off time
   *
   */
 
-void PTT_Key_Off_Time (void)
+__HOT_FUNC void PTT_Key_Off_Time (void)
 {
-  ptt.key_off_time = trx.sysclock;
+  ptt.key_off_time  = TIME_Get_Us ();
+  ptt.key_off_is_on = 1U;
+}
+
+/**
+  * @brief This function sets PTT hang time after releasing the telegraph key
+  *
+  * @param Hang time in ms
+  *
+  */
+
+void PTT_Set_Hang_Time (uint32_t hang_time)
+{
+  ptt.hang_time = hang_time;
+}
+
+/**
+  * @brief This function toggles VFO A and VFO B
+  *
+  */
+
+void VFO_Toggle_VFO (void)
+{
+  vfo.active ^= 1U;
+}
+
+/**
+  * @brief This function sets frequency of the active VFO
+  *
+  * @param Frequency in Hz
+  *
+  */
+
+void VFO_Set_Tune (uint32_t tune)
+{
+  VFO_Set_VFO_Tune (vfo.active, tune);
+}
+
+/**
+  * @brief This function sets frequency of VFO A or VFO B
+  *
+  * @param 0 - VFO A, 1 - VFO B
+  * @param Frequency in Hz
+  *
+  */
+
+void VFO_Set_VFO_Tune (uint8_t n, uint32_t tune)
+{
+  if (n > 1U) return;
+
+  vfo.tune [n] = tune;
+}
+
+/**
+  * @brief This function sets frequency of the active VFO in BCD
+  *
+  * 8 packed BCD digits in 10 Hz units, as in Yaesu CAT.
+  * A value with a digit above 9 is ignored
+  *
+  * @param Frequency in BCD
+  *
+  */
+
+void VFO_Set_Tune_BCD (uint32_t bcd)
+{
+  uint32_t tune = 0U;
+
+  for (int32_t i = 28; i >= 0; i -= 4)
+  {
+    uint32_t digit = (bcd >> i) & 0x0FU;
+
+    if (digit > 9U) return;
+
+    tune = tune * 10U + digit;
+  }
+
+  VFO_Set_Tune (tune * 10U);
+}
+
+/**
+  * @brief This function returns frequency of the active VFO
+  *
+  * @retval Frequency in Hz
+  *
+  */
+
+uint32_t VFO_Get_Tune (void)
+{
+  return vfo.tune [vfo.active];
+}
+
+/**
+  * @brief This function returns frequency of VFO A or VFO B
+  *
+  * @param 0 - VFO A, 1 - VFO B
+  * @retval Frequency in Hz
+  *
+  */
+
+uint32_t VFO_Get_VFO_Tune (uint8_t n)
+{
+  return vfo.tune [n & 1U];
+}
+
+/**
+  * @brief This function returns frequency of the active VFO in BCD
+  *
+  * @retval 8 packed BCD digits in 10 Hz units
+  *
+  */
+
+uint32_t VFO_Get_Tune_BCD (void)
+{
+  uint32_t tune = VFO_Get_Tune () / 10U;
+  uint32_t bcd  = 0U;
+
+  for (uint32_t i = 0U; i < 32U; i += 4U)
+  {
+    bcd  |= (tune % 10U) << i;
+    tune /= 10U;
+  }
+
+  return bcd;
+}
+
+/**
+  * @brief This function sets split mode
+  *
+  */
+
+void VFO_Set_Split (uint8_t split)
+{
+  vfo.split = split;
 }
 
 /**
@@ -146,6 +432,15 @@ void PTT_Init (void)
   trx.is_tx = 0U;
   HAL_GPIO_WritePin (TX_GPIO_Port, TX_Pin, GPIO_PIN_SET);
 
+  vfo.tune [0] = VFO_DEFAULT_TUNE;
+  vfo.tune [1] = VFO_DEFAULT_TUNE;
+  vfo.active   = 0U;
+  vfo.split    = 0U;
+
+  trx.mode = TRX_MODE_CW;
+
+  ptt.hang_time = PTT_HANG_TIME;
+
   DSP_Init ();
 }
 
@@ -157,11 +452,37 @@ void PTT_Init (void)
 
 void PTT_Handler (void)
 {
-  if (ptt.key_off_time != 0U)
+  uint32_t primask;
+  uint32_t now;
+
+  /* The last edge of a bounce may be ignored, the paddle state is taken again */
+  if (ptt.key_bounce)
   {
-    if ((trx.sysclock - ptt.key_off_time) > KEY_TIMEOUT)
+    primask = __get_PRIMASK ();
+    __disable_irq ();
+
+    now = TIME_Get_Us ();
+
+    if ((ptt.key_bounce & PTT_DAH) && ((now - ptt.key_dah_time) >= (PTT_DEBOUNCE_TIME * 1000U)))
     {
-      ptt.key_off_time = 0U;
+      ptt.key_bounce &= ~PTT_DAH;
+      ptt_paddle (PTT_DAH);
+    }
+
+    if ((ptt.key_bounce & PTT_DIT) && ((now - ptt.key_dit_time) >= (PTT_DEBOUNCE_TIME * 1000U)))
+    {
+      ptt.key_bounce &= ~PTT_DIT;
+      ptt_paddle (PTT_DIT);
+    }
+
+    __set_PRIMASK (primask);
+  }
+
+  if (ptt.key_off_is_on)
+  {
+    if ((TIME_Get_Us () - ptt.key_off_time) >= (ptt.hang_time * 1000U))
+    {
+      ptt.key_off_is_on = 0U;
       ptt_set_rx ();
     }
   }
@@ -180,22 +501,10 @@ void HAL_GPIO_EXTI_Callback (uint16_t GPIO_Pin)
   switch (GPIO_Pin)
   {
     case KEY_DAH_Pin:
-      ptt.key_dah_is_on = !HAL_GPIO_ReadPin (KEY_DAH_GPIO_Port, KEY_DAH_Pin);
-
-      if (ptt.key_dah_is_on)
-      {
-        ptt_set_tx ();
-      }
-
+      ptt_paddle (PTT_DAH);
       break;
     case KEY_DIT_Pin:
-      ptt.key_dit_is_on = !HAL_GPIO_ReadPin (KEY_DIT_GPIO_Port, KEY_DIT_Pin);
-
-      if (ptt.key_dit_is_on)
-      {
-        ptt_set_tx ();
-      }
-
+      ptt_paddle (PTT_DIT);
       break;
   }
 }
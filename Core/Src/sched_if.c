@@ -0,0 +1,333 @@
+/**
+  *******************************************************************************
+  *
+  * @file    sched_if.c
+  * @brief   Main loop task scheduler
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  *
+  * The main loop tasks run to completion in priority order. A task is
+  * released periodically, by SCHED_Post () from an interrupt handler or
+  * both. When no task is due the core sleeps in WFI until an interrupt
+  * or the next periodic release, which is armed on TIM2 channel 4.
+  *
+  * Each task keeps its run count, deadline overruns, the longest delay
+  * from release to start (jitter) and the longest run in us. They are
+  * read by CAT command ZS, see cat_if.c.
+  *
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "sched_if.h"
+#include "time_if.h"
+#include "mon_if.h"
+#include "lp_if.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+SCHED_Task_TypeDef sched_task [SCHED_TASKS];
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+extern TIM_HandleTypeDef htim2;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function runs a task if it is due
+ *
+ * @param Task
+ * @retval 1 - the task has run, 0 - it is not due
+ */
+
+static uint8_t sched_task_run (SCHED_Task_TypeDef *t)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint32_t now     = TIME_Get_Us ();
+  uint32_t release = now;
+  uint32_t end;
+  uint8_t  due     = 0U;
+
+  if (t->handler == NULL) return 0U;
+
+  /* A post made while the task runs releases it once more */
+  __disable_irq ();
+
+  if (t->posted)
+  {
+    t->posted = 0U;
+    release   = t->post_time;
+    due       = 1U;
+  }
+
+  __set_PRIMASK (primask);
+
+  if (t->period && ((int32_t) (now - t->release) >= 0))
+  {
+    if (!due || ((int32_t) (t->release - release) < 0))
+    {
+      release = t->release;
+    }
+
+    due = 1U;
+    t->release += t->period;
+
+    /* Releases missed while the task was late are dropped, not queued */
+    if ((int32_t) (now - t->release) >= 0)
+    {
+      t->release = now + t->period;
+    }
+  }
+
+  if (!due) return 0U;
+
+  t->handler ();
+
+  end = TIME_Get_Us ();
+
+  t->runs++;
+
+  if ((now - release) > t->jitter_max) t->jitter_max = now - release;
+  if ((end - now) > t->run_max)        t->run_max    = end - now;
+
+  if ((end - release) > t->deadline)
+  {
+    t->overruns++;
+  }
+
+  return 1U;
+}
+
+/**
+ * @brief This function finds the next periodic release
+ *
+ * @param Next release, us
+ * @retval 1 - there is a periodic task, 0 - there is none
+ */
+
+static uint8_t sched_next_release (uint32_t *next)
+{
+  uint8_t found = 0U;
+
+  for (uint32_t n = 0U; n < SCHED_TASKS; n++)
+  {
+    SCHED_Task_TypeDef *t = &sched_task [n];
+
+    if ((t->handler == NULL) || (t->period == 0U)) continue;
+
+    if (!found || ((int32_t) (t->release - *next) < 0))
+    {
+      *next = t->release;
+      found = 1U;
+    }
+  }
+
+  return found;
+}
+
+/**
+ * @brief This function sleeps until an interrupt
+ *
+ * TIM2 channel 4 wakes the core at the next periodic release.
+ * The check and WFI are done with interrupts masked, so a post
+ * or a release in between is not slept over: a pending interrupt
+ * ends WFI at once
+ *
+ */
+
+static void sched_sleep (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint32_t next;
+  uint8_t  periodic = sched_next_release (&next);
+  uint8_t  posted   = 0U;
+
+  __disable_irq ();
+
+  if (periodic)
+  {
+    TIM2->CCR4 = next;
+    __HAL_TIM_CLEAR_FLAG (&htim2, TIM_FLAG_CC4);
+  }
+
+  for (uint32_t n = 0U; n < SCHED_TASKS; n++)
+  {
+    posted |= sched_task [n].posted;
+  }
+
+  /* USB suspend stops the core whatever is due, LP_Sleep () sets RX first */
+  if (lp.suspended || (!posted && (!periodic || ((int32_t) (next - TIME_Get_Us ()) > 0))))
+  {
+    LP_Sleep ();
+  }
+
+  __set_PRIMASK (primask);
+
+  MON_Wake ();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function adds a task
+ *
+ * A periodic task is released first at once
+ *
+ * @param Task, SCHED_xxx
+ * @param Name for ZS answer
+ * @param Handler
+ * @param Period, ms, 0 - the task is run by SCHED_Post () only
+ * @param Deadline from release, ms
+ */
+
+void SCHED_Add (uint8_t n, const char *name, SCHED_Handler handler, uint32_t period, uint32_t deadline)
+{
+  SCHED_Task_TypeDef *t;
+
+  if (n >= SCHED_TASKS) return;
+
+  t = &sched_task [n];
+
+  t->name     = name;
+  t->period   = period * 1000U;
+  t->deadline = deadline * 1000U;
+  t->release  = TIME_Get_Us ();
+  t->handler  = handler;
+}
+
+/**
+ * @brief This function releases a task
+ *
+ * It may be called from any context. Posts made before the task
+ * has run are merged, the first one is its release time
+ *
+ * @param Task, SCHED_xxx
+ */
+
+void SCHED_Post (uint8_t n)
+{
+  uint32_t primask = __get_PRIMASK ();
+  SCHED_Task_TypeDef *t;
+
+  if (n >= SCHED_TASKS) return;
+
+  t = &sched_task [n];
+
+  __disable_irq ();
+
+  if (!t->posted)
+  {
+    t->post_time = TIME_Get_Us ();
+    t->posted    = 1U;
+  }
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function is the main loop pass
+ *
+ * The due tasks are run in priority order, the core sleeps if none was
+ *
+ */
+
+void SCHED_Run (void)
+{
+  uint8_t ran = 0U;
+
+  for (uint32_t n = 0U; n < SCHED_TASKS; n++)
+  {
+    ran |= sched_task_run (&sched_task [n]);
+  }
+
+  if (!ran)
+  {
+    sched_sleep ();
+  }
+}
+
+/**
+ * @brief This function clears the task statistics
+ *
+ */
+
+void SCHED_Reset (void)
+{
+  for (uint32_t n = 0U; n < SCHED_TASKS; n++)
+  {
+    sched_task [n].runs       = 0U;
+    sched_task [n].overruns   = 0U;
+    sched_task [n].jitter_max = 0U;
+    sched_task [n].run_max    = 0U;
+  }
+}
+
+/**
+ * @brief This function formats a task as CAT answer
+ *
+ * ZSn,name,period,deadline,runs,overruns,jitter max,run max; with times in us
+ *
+ * @param Task
+ * @param Answer buffer
+ * @param Buffer size, SCHED_LINE_SIZE is enough
+ * @retval Answer length, 0 if the task does not exist
+ */
+
+uint32_t SCHED_Format (uint8_t n, char *buff, uint32_t size)
+{
+  SCHED_Task_TypeDef *t;
+
+  if ((n >= SCHED_TASKS) || (sched_task [n].handler == NULL)) return 0U;
+
+  t = &sched_task [n];
+
+  /* The statistics are updated by the main loop only, as this is */
+  return snprintf (buff, size, "ZS%u,%s,%lu,%lu,%lu,%lu,%lu,%lu;", (unsigned int) n, t->name,
+                   (unsigned long) t->period,
+                   (unsigned long) t->deadline,
+                   (unsigned long) t->runs,
+                   (unsigned long) t->overruns,
+                   (unsigned long) t->jitter_max,
+                   (unsigned long) t->run_max);
+}
+
+/**
+ * @brief This function starts the scheduler
+ *
+ * It is called after TIME_Init (), TIM2 channel 4 is left in frozen mode
+ * and only its compare interrupt is used
+ *
+ */
+
+void SCHED_Init (void)
+{
+  memset (sched_task, 0, sizeof (sched_task));
+
+  __HAL_TIM_CLEAR_FLAG (&htim2, TIM_FLAG_CC4);
+  __HAL_TIM_ENABLE_IT (&htim2, TIM_IT_CC4);
+}
+
+/****END OF FILE****/
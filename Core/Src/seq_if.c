@@ -0,0 +1,444 @@
+/**
+  *******************************************************************************
+  *
+  * @file    seq_if.c
+  * @brief   Key and PTT Output Sequencer
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  *
+  * Key out, amplifier PTT and T/R relay lines are TIM2 output compare
+  * channels. Edges are queued with their time and the timer switches
+  * the pins itself at the exact microsecond.
+  *
+  * Key out and TX audio follow keyer edges delayed by the longest lead
+  * time, so PTT lines switched on at the first keyer edge are ahead of
+  * RF by their own lead time. PTT lines are released their own tail
+  * time after the last key out release. Without the audio delay
+  * PTT lines and key out switch together with the keyer.
+  *
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "seq_if.h"
+#include "time_if.h"
+#include "dsp_if.h"
+#include "cw_gen.h"
+
+#include <stdio.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* The longest lead the TX delay line can hold, us */
+#define SEQ_LEAD_MAX                          (((DSP_DELAY_SIZE - 1U) * 1000U) / CW_SAMPLES_PER_MS)
+
+#if (SEQ_AMP_LEAD > SEQ_LEAD_MAX) || (SEQ_RELAY_LEAD > SEQ_LEAD_MAX)
+#error "SEQ_xxx_LEAD is longer than the TX delay line, increase DSP_DELAY_SIZE"
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+SEQ_TypeDef seq;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+extern TIM_HandleTypeDef htim2;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function sets output compare mode of a channel
+ *
+ * @param Output number
+ * @param TIM_OCMODE_xxx
+ */
+
+static __HOT_FUNC void seq_set_mode (uint8_t n, uint32_t mode)
+{
+  switch (n)
+  {
+    case SEQ_KEY:
+      MODIFY_REG (TIM2->CCMR1, TIM_CCMR1_OC1M, mode);
+      break;
+    case SEQ_AMP:
+      MODIFY_REG (TIM2->CCMR1, TIM_CCMR1_OC2M, mode << 8U);
+      break;
+    case SEQ_RELAY:
+      MODIFY_REG (TIM2->CCMR2, TIM_CCMR2_OC3M, mode);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief This function arms the first queued event of an output
+ *
+ * Events which time has come are applied at once
+ *
+ * @param Output number
+ */
+
+static __HOT_FUNC void seq_arm (uint8_t n)
+{
+  SEQ_Output_TypeDef *out = &seq.out [n];
+  SEQ_Event_TypeDef  *ev;
+
+  while (out->rd_ptr != out->wr_ptr)
+  {
+    ev = &out->queue [out->rd_ptr & (SEQ_QUEUE_SIZE - 1U)];
+
+    if ((int32_t) (ev->time - TIME_Get_Us ()) > (int32_t) SEQ_MARGIN)
+    {
+      (&TIM2->CCR1) [n] = ev->time;
+      TIM2->SR = ~(TIM_SR_CC1IF << n);
+      seq_set_mode (n, ev->on ? TIM_OCMODE_ACTIVE : TIM_OCMODE_INACTIVE);
+      return;
+    }
+
+    seq_set_mode (n, ev->on ? TIM_OCMODE_FORCED_ACTIVE : TIM_OCMODE_FORCED_INACTIVE);
+    out->rd_ptr++;
+  }
+}
+
+/**
+ * @brief This function queues an output edge
+ *
+ * It must be called with interrupts disabled
+ *
+ * @param Output number
+ * @param Time, us
+ * @param 1 - on, 0 - off
+ * @param 1 - a pending edge of opposite state is cancelled instead
+ */
+
+static __HOT_FUNC void seq_put (uint8_t n, uint32_t time, uint8_t on, uint8_t cancel)
+{
+  SEQ_Output_TypeDef *out = &seq.out [n];
+  SEQ_Event_TypeDef  *last;
+  uint32_t           pending = out->wr_ptr - out->rd_ptr;
+
+  if (cancel && pending && (out->on != on))
+  {
+    last = &out->queue [(out->wr_ptr - 1U) & (SEQ_QUEUE_SIZE - 1U)];
+
+    if (pending > 1U)
+    {
+      out->wr_ptr--;
+      out->on = on;
+      return;
+    }
+
+    /* The edge is armed: it may be cancelled only if it has not happened */
+    if (!(TIM2->SR & (TIM_SR_CC1IF << n)) &&
+        ((int32_t) (last->time - TIME_Get_Us ()) > (int32_t) SEQ_MARGIN))
+    {
+      seq_set_mode (n, TIM_OCMODE_TIMING);
+      out->wr_ptr--;
+      out->on = on;
+      return;
+    }
+  }
+
+  if (out->on == on) return;
+
+  if (pending >= SEQ_QUEUE_SIZE)
+  {
+    seq.overflows++;
+    return;
+  }
+
+  out->queue [out->wr_ptr & (SEQ_QUEUE_SIZE - 1U)].time = time;
+  out->queue [out->wr_ptr & (SEQ_QUEUE_SIZE - 1U)].on   = on;
+  out->wr_ptr++;
+  out->on = on;
+
+  if (pending == 0U)
+  {
+    seq_arm (n);
+  }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function puts keyer edge to key out line
+ *
+ * @param 1 - key down, 0 - key up
+ * @param Time of the edge in the audio, us
+ */
+
+__HOT_FUNC void SEQ_Key (uint8_t key, uint32_t time)
+{
+  uint32_t primask = __get_PRIMASK ();
+
+  __disable_irq ();
+
+  time += seq.delay;
+
+  seq_put (SEQ_KEY, time, key, 0U);
+
+  if (!key)
+  {
+    seq.key_off_time = time;
+  }
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function switches PTT lines
+ *
+ * @param 1 - TX, 0 - RX
+ */
+
+__HOT_FUNC void SEQ_PTT (uint8_t ptt)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint32_t now;
+
+  __disable_irq ();
+
+  now = TIME_Get_Us ();
+
+  if (ptt)
+  {
+    seq_put (SEQ_AMP,   now + seq.delay - seq.out [SEQ_AMP].lead,   1U, 1U);
+    seq_put (SEQ_RELAY, now + seq.delay - seq.out [SEQ_RELAY].lead, 1U, 1U);
+  }
+  else
+  {
+    /* Tail time is counted from the last key out release */
+    if ((int32_t) (seq.key_off_time - now) > 0)
+    {
+      now = seq.key_off_time;
+    }
+
+    seq_put (SEQ_AMP,   now + seq.out [SEQ_AMP].tail,   0U, 1U);
+    seq_put (SEQ_RELAY, now + seq.out [SEQ_RELAY].tail, 0U, 1U);
+  }
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function releases all the outputs at once
+ *
+ * The queued edges are dropped. It is called before the core stops,
+ * as the timer stops too and an armed edge would wait for the wake up
+ *
+ */
+
+void SEQ_Idle (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+
+  __disable_irq ();
+
+  for (uint8_t n = 0U; n < SEQ_OUT_NUM; n++)
+  {
+    seq.out [n].rd_ptr = seq.out [n].wr_ptr;
+    seq.out [n].on     = 0U;
+
+    seq_set_mode (n, TIM_OCMODE_FORCED_INACTIVE);
+    TIM2->SR = ~(TIM_SR_CC1IF << n);
+  }
+
+  seq.key_off_time = TIME_Get_Us ();
+
+  __set_PRIMASK (primask);
+}
+
+/**
+ * @brief This function sets lead and tail time of a PTT line
+ *
+ * The TX audio is delayed by the lead, so a lead longer than the delay
+ * line holds is refused: the first element would be clipped
+ *
+ * @param Output number
+ * @param Lead time, us, up to SEQ_Get_Lead_Max ()
+ * @param Tail time, us
+ * @retval 1 - set, 0 - refused
+ */
+
+uint8_t SEQ_Set_Timing (uint8_t n, uint32_t lead, uint32_t tail)
+{
+  if ((n == SEQ_KEY) || (n >= SEQ_OUT_NUM) || (lead > SEQ_LEAD_MAX)) return 0U;
+
+  seq.out [n].lead = lead;
+  seq.out [n].tail = tail;
+
+  SEQ_Set_Audio_Delay (seq.audio_delay);
+
+  return 1U;
+}
+
+/**
+ * @brief This function returns the longest lead time
+ *
+ * @retval Lead time the TX delay line can hold, us
+ */
+
+uint32_t SEQ_Get_Lead_Max (void)
+{
+  return SEQ_LEAD_MAX;
+}
+
+/**
+ * @brief This function turns TX audio delay on or off
+ *
+ * The delay is the longest lead time of PTT lines
+ *
+ * @param 1 - on, 0 - off
+ */
+
+void SEQ_Set_Audio_Delay (uint8_t audio_delay)
+{
+  uint32_t delay = 0U;
+
+  seq.audio_delay = audio_delay;
+
+  if (audio_delay)
+  {
+    /* SEQ_Set_Timing () keeps the leads within the delay line */
+    for (uint8_t n = SEQ_AMP; n < SEQ_OUT_NUM; n++)
+    {
+      if (delay < seq.out [n].lead)
+      {
+        delay = seq.out [n].lead;
+      }
+    }
+  }
+
+  seq.delay = delay;
+
+  DSP_Set_Delay ((delay * CW_SAMPLES_PER_MS) / 1000U);
+}
+
+/**
+ * @brief This function returns key out delay
+ *
+ * @retval Delay from keyer edge to key out edge, us
+ */
+
+uint32_t SEQ_Get_Delay (void)
+{
+  return seq.delay;
+}
+
+/**
+ * @brief This function returns TX audio delay state
+ *
+ * @retval 1 - on, 0 - off
+ */
+
+uint8_t SEQ_Get_Audio_Delay (void)
+{
+  return seq.audio_delay;
+}
+
+/**
+ * @brief This function formats the timing of a PTT line as CAT answer
+ *
+ * ZQn,lead,tail; with times in us
+ *
+ * @param Output number, SEQ_AMP or SEQ_RELAY
+ * @param Answer buffer
+ * @param Buffer size, SEQ_LINE_SIZE is enough
+ * @retval Answer length, 0 if the output has no timing
+ */
+
+uint32_t SEQ_Format (uint8_t n, char *buff, uint32_t size)
+{
+  if ((n == SEQ_KEY) || (n >= SEQ_OUT_NUM)) return 0U;
+
+  return snprintf (buff, size, "ZQ%u,%lu,%lu;", (unsigned int) n,
+                   (unsigned long) seq.out [n].lead,
+                   (unsigned long) seq.out [n].tail);
+}
+
+/**
+ * @brief This function initialize the sequencer outputs
+ *
+ */
+
+void SEQ_Init (void)
+{
+  for (uint8_t n = 0U; n < SEQ_OUT_NUM; n++)
+  {
+    seq.out [n].wr_ptr = 0U;
+    seq.out [n].rd_ptr = 0U;
+    seq.out [n].on     = 0U;
+    seq.out [n].lead   = 0U;
+    seq.out [n].tail   = 0U;
+
+    seq_set_mode (n, TIM_OCMODE_FORCED_INACTIVE);
+  }
+
+  seq.audio_delay = 1U;
+
+  SEQ_Set_Timing (SEQ_AMP,   SEQ_AMP_LEAD,   SEQ_AMP_TAIL);
+  SEQ_Set_Timing (SEQ_RELAY, SEQ_RELAY_LEAD, SEQ_RELAY_TAIL);
+
+  seq.key_off_time = TIME_Get_Us ();
+  seq.overflows    = 0U;
+
+  HAL_TIM_OC_Start_IT (&htim2, TIM_CHANNEL_1);
+  HAL_TIM_OC_Start_IT (&htim2, TIM_CHANNEL_2);
+  HAL_TIM_OC_Start_IT (&htim2, TIM_CHANNEL_3);
+}
+
+/**
+ * @brief This function is TIM output compare handler
+ *
+ * The armed edge has happened: the next one is armed
+ *
+ * @param TIM handle
+ */
+
+void HAL_TIM_OC_DelayElapsedCallback (TIM_HandleTypeDef *htim)
+{
+  uint8_t n;
+
+  if (htim->Instance != TIM2) return;
+
+  switch (htim->Channel)
+  {
+    case HAL_TIM_ACTIVE_CHANNEL_1:
+      n = SEQ_KEY;
+      break;
+    case HAL_TIM_ACTIVE_CHANNEL_2:
+      n = SEQ_AMP;
+      break;
+    case HAL_TIM_ACTIVE_CHANNEL_3:
+      n = SEQ_RELAY;
+      break;
+    default:
+      return;
+  }
+
+  if (seq.out [n].rd_ptr != seq.out [n].wr_ptr)
+  {
+    seq.out [n].rd_ptr++;
+    seq_arm (n);
+  }
+}
+
+/****END OF FILE****/
@@ -23,6 +23,9 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "prof_if.h"
+#include "mon_if.h"
+#include "usbd_audio_if.h"
 
 /* USER CODE END Includes */
 
@@ -48,6 +51,8 @@
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN PFP */
+/* The audio render handler runs from RAM with the rest of the hot path */
+__HOT_FUNC void PendSV_Handler(void);
 
 /* USER CODE END PFP */
 
@@ -59,10 +64,9 @@
 /* External variables --------------------------------------------------------*/
 extern PCD_HandleTypeDef hpcd_USB_OTG_FS;
 extern ADC_HandleTypeDef hadc1;
+extern TIM_HandleTypeDef htim2;
 /* USER CODE BEGIN EV */
 
-extern TRX_TypeDef trx;
-
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -173,6 +177,11 @@ void DebugMon_Handler(void)
 void PendSV_Handler(void)
 {
   /* USER CODE BEGIN PendSV_IRQn 0 */
+  MON_ISR_ENTER ();
+
+  AUDIO_Render_FS ();
+
+  MON_ISR_EXIT (MON_RENDER);
 
   /* USER CODE END PendSV_IRQn 0 */
   /* USER CODE BEGIN PendSV_IRQn 1 */
@@ -186,18 +195,13 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
+  MON_Tick ();
+  MON_ISR_ENTER ();
 
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
-
-  trx.systicks--;
-
-  if (trx.systicks == 0)
-  {
-    trx.systicks = 10;
-    trx.sysclock++;
-  }
+  MON_ISR_EXIT (MON_TICK);
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -215,10 +219,14 @@ void SysTick_Handler(void)
 void EXTI0_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI0_IRQn 0 */
+  MON_ISR_ENTER ();
+  PROF_START (PROF_EXTI);
 
   /* USER CODE END EXTI0_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(KEY_DIT_Pin);
   /* USER CODE BEGIN EXTI0_IRQn 1 */
+  PROF_STOP (PROF_EXTI);
+  MON_ISR_EXIT (MON_EXTI);
 
   /* USER CODE END EXTI0_IRQn 1 */
 }
@@ -229,10 +237,14 @@ void EXTI0_IRQHandler(void)
 void EXTI1_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI1_IRQn 0 */
+  MON_ISR_ENTER ();
+  PROF_START (PROF_EXTI);
 
   /* USER CODE END EXTI1_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(KEY_DAH_Pin);
   /* USER CODE BEGIN EXTI1_IRQn 1 */
+  PROF_STOP (PROF_EXTI);
+  MON_ISR_EXIT (MON_EXTI);
 
   /* USER CODE END EXTI1_IRQn 1 */
 }
@@ -243,28 +255,63 @@ void EXTI1_IRQHandler(void)
 void ADC_IRQHandler(void)
 {
   /* USER CODE BEGIN ADC_IRQn 0 */
+  MON_ISR_ENTER ();
 
   /* USER CODE END ADC_IRQn 0 */
   HAL_ADC_IRQHandler(&hadc1);
   /* USER CODE BEGIN ADC_IRQn 1 */
+  MON_ISR_EXIT (MON_ADC);
 
   /* USER CODE END ADC_IRQn 1 */
 }
 
+/**
+  * @brief This function handles TIM2 global interrupt.
+  */
+void TIM2_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM2_IRQn 0 */
+  MON_ISR_ENTER ();
+
+  /* USER CODE END TIM2_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim2);
+  /* USER CODE BEGIN TIM2_IRQn 1 */
+  MON_ISR_EXIT (MON_TIM);
+
+  /* USER CODE END TIM2_IRQn 1 */
+}
+
 /**
   * @brief This function handles USB On The Go FS global interrupt.
   */
 void OTG_FS_IRQHandler(void)
 {
   /* USER CODE BEGIN OTG_FS_IRQn 0 */
+  MON_ISR_ENTER ();
+  PROF_START (PROF_USB_ISR);
 
   /* USER CODE END OTG_FS_IRQn 0 */
   HAL_PCD_IRQHandler(&hpcd_USB_OTG_FS);
   /* USER CODE BEGIN OTG_FS_IRQn 1 */
+  PROF_STOP (PROF_USB_ISR);
+  MON_ISR_EXIT (MON_USB);
 
   /* USER CODE END OTG_FS_IRQn 1 */
 }
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles USB On The Go FS Wakeup through EXTI line interrupt.
+  *        The clocks and the PHY clock are restored by LP_Sleep () already.
+  */
+void OTG_FS_WKUP_IRQHandler(void)
+{
+  MON_ISR_ENTER ();
+
+  __HAL_USB_OTG_FS_WAKEUP_EXTI_CLEAR_FLAG ();
+
+  MON_ISR_EXIT (MON_USB);
+}
+
 /* USER CODE END 1 */
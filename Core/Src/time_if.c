@@ -0,0 +1,123 @@
+/**
+  *******************************************************************************
+  *
+  * @file    time_if.c
+  * @brief   Microsecond Timebase
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  *
+  * TIM2 is a free running 32 bit counter clocked at 1 MHz: the 96 MHz
+  * timer clock is divided by PSC + 1 = 96, so the prescaler is set to 95.
+  * Its overflow interrupt extends the time to 64 bits.
+  *
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "time_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+static __IO uint32_t time_high;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+extern TIM_HandleTypeDef htim2;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function returns free running microsecond time
+ *
+ * A single read of the 32 bit timer counter is atomic, so it may be
+ * called from any context. The time wraps every 71.6 minutes,
+ * intervals are computed as unsigned differences.
+ *
+ * @retval Time in us
+ */
+
+__HOT_FUNC uint32_t TIME_Get_Us (void)
+{
+  return TIM2->CNT;
+}
+
+/**
+ * @brief This function returns 64 bit microsecond time
+ *
+ * The overflow which is pending but not handled yet is taken
+ * into account, so it may be called from any context
+ *
+ * @retval Time in us
+ */
+
+uint64_t TIME_Get_Us64 (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint32_t high;
+  uint32_t low;
+
+  __disable_irq ();
+
+  high = time_high;
+  low  = TIM2->CNT;
+
+  if ((TIM2->SR & TIM_SR_UIF) && (low < 0x80000000U))
+  {
+    high++;
+  }
+
+  __set_PRIMASK (primask);
+
+  return ((uint64_t) high << 32U) | low;
+}
+
+/**
+ * @brief This function starts microsecond timebase
+ *
+ */
+
+void TIME_Init (void)
+{
+  time_high = 0U;
+
+  /* Update event of the timer init must not be counted as overflow */
+  __HAL_TIM_CLEAR_FLAG (&htim2, TIM_FLAG_UPDATE);
+  HAL_TIM_Base_Start_IT (&htim2);
+}
+
+/**
+ * @brief This function is TIM period elapsed handler
+ *
+ * @param TIM handle
+ */
+
+void HAL_TIM_PeriodElapsedCallback (TIM_HandleTypeDef *htim)
+{
+  if (htim->Instance == TIM2)
+  {
+    time_high++;
+  }
+}
+
+/****END OF FILE****/
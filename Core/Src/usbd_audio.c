@@ -149,6 +149,11 @@ static void AUDIO_REQ_SetCurrent(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
 
 USBD_AUDIO_HandleTypeDef USBD_AUDIO_Handle;
 
+/* The Audio class keeps its own handle and callbacks: pdev->pClassData and
+ * pdev->pUserData belong to the CDC class of the composite device */
+static USBD_AUDIO_HandleTypeDef *pAudioClassData = NULL;
+static USBD_AUDIO_ItfTypeDef    *pAudioUserData  = NULL;
+
 USBD_ClassTypeDef  USBD_AUDIO =
 {
   USBD_AUDIO_Init,
@@ -469,15 +474,15 @@ static uint8_t USBD_AUDIO_Init (USBD_HandleTypeDef *pdev, uint8_t cfgidx)
   pdev->ep_in[AUDIO_IN_EP & 0xFU].is_used = 1U;
 
   /* Allocate Audio structure */
-  pdev->pClassData = (void*) &USBD_AUDIO_Handle;
+  pAudioClassData = &USBD_AUDIO_Handle;
 
-  if (pdev->pClassData == NULL)
+  if (pAudioClassData == NULL)
   {
     return USBD_FAIL;
   }
   else
   {
-    haudio = (USBD_AUDIO_HandleTypeDef*) pdev->pClassData;
+    haudio = pAudioClassData;
 
     for (uint8_t i = 0; i <= USBD_MAX_NUM_INTERFACES; i++)
     {
@@ -497,9 +502,9 @@ static uint8_t USBD_AUDIO_Init (USBD_HandleTypeDef *pdev, uint8_t cfgidx)
     memset ((uint8_t*) haudio->in.buff, 0, AUDIO_TOTAL_BUF_SIZE);
 
     /* Initialize the Audio output Hardware layer */
-    if (((USBD_AUDIO_ItfTypeDef*) pdev->pUserData)->Init (USBD_AUDIO_FREQ,
-                                                          AUDIO_DEFAULT_VOLUME,
-                                                          0U) != 0)
+    if (pAudioUserData->Init (USBD_AUDIO_FREQ,
+                              AUDIO_DEFAULT_VOLUME,
+                              0U) != 0)
     {
       return USBD_FAIL;
     }
@@ -529,10 +534,10 @@ static uint8_t  USBD_AUDIO_DeInit (USBD_HandleTypeDef *pdev, uint8_t cfgidx)
   pdev->ep_in[AUDIO_IN_EP & 0xFU].is_used = 0U;
 
   /* DeInit  physical Interface components */
-  if (pdev->pClassData != NULL)
+  if (pAudioClassData != NULL)
   {
-    ((USBD_AUDIO_ItfTypeDef*) pdev->pUserData)->DeInit (0U);
-    pdev->pClassData = NULL;
+    pAudioUserData->DeInit (0U);
+    pAudioClassData = NULL;
   }
 
   return USBD_OK;
@@ -554,7 +559,7 @@ static uint8_t  USBD_AUDIO_Setup (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
   uint16_t status_info = 0U;
   uint8_t  ret = USBD_OK;
 
-  haudio = (USBD_AUDIO_HandleTypeDef*) pdev->pClassData;
+  haudio = pAudioClassData;
 
   switch (req->bmRequest & USB_REQ_TYPE_MASK)
   {
@@ -623,9 +628,9 @@ static uint8_t  USBD_AUDIO_Setup (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
            /* Handles Alternate Settings 0 of Audio OUT interface */
            if (haudio->alt_setting[AUDIO_OUT_IF] == 0)
            {
-             ((USBD_AUDIO_ItfTypeDef *) pdev->pUserData)->AudioCmd (&haudio->out.buff[0],
-                                                                    AUDIO_TOTAL_BUF_SIZE / 2U,
-                                                                    AUDIO_CMD_STOP);
+             pAudioUserData->AudioCmd (&haudio->out.buff[0],
+                                       AUDIO_TOTAL_BUF_SIZE / 2U,
+                                       AUDIO_CMD_STOP);
            }
 
            /* Handles Alternate Settings 1 of Audio IN interface */
@@ -633,11 +638,14 @@ static uint8_t  USBD_AUDIO_Setup (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
            {
              if (!haudio->in.buff_enable)
              {
-               /* Prepare IN endpoint to send 1st packet */
-               ((USBD_AUDIO_ItfTypeDef *) pdev->pUserData)->AudioCmd (&haudio->in.buff[0],
-                                                                      AUDIO_TOTAL_BUF_SIZE / 2U,
-                                                                      AUDIO_CMD_RECORD);
-               haudio->in.wr_ptr = AUDIO_TOTAL_BUF_SIZE / 2U;
+               /* Prepare IN endpoint to send 1st packet, it is silent as
+                  packets are rendered one packet ahead, after this returns */
+               memset (haudio->in.buff, 0, AUDIO_TOTAL_BUF_SIZE / 2U);
+               pAudioUserData->AudioCmd (&haudio->in.buff[AUDIO_TOTAL_BUF_SIZE / 2U],
+                                         AUDIO_TOTAL_BUF_SIZE / 2U,
+                                         AUDIO_CMD_RECORD);
+               haudio->in.wr_ptr = 0U;
+               haudio->in.rd_ptr = 0U;
                haudio->in.buff_enable = 1U;
 
                USBD_LL_FlushEP (pdev, AUDIO_IN_EP);
@@ -703,28 +711,28 @@ static uint8_t *USBD_AUDIO_GetCfgDesc (uint16_t *length)
   * @retval status
   */
 
-static uint8_t USBD_AUDIO_DataIn (USBD_HandleTypeDef *pdev, uint8_t epnum)
+static __HOT_FUNC uint8_t USBD_AUDIO_DataIn (USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
   USBD_AUDIO_HandleTypeDef *haudio;
   uint8_t retval = USBD_OK;
 
-  haudio = (USBD_AUDIO_HandleTypeDef*) pdev->pClassData;
+  haudio = pAudioClassData;
 
   if (epnum == (AUDIO_IN_EP & 0x7F))
   {
     if (haudio->in.rd_ptr == AUDIO_TOTAL_BUF_SIZE / 2U)
     {
-      ((USBD_AUDIO_ItfTypeDef *) pdev->pUserData)->AudioCmd (&haudio->in.buff[0],
-                                                             AUDIO_TOTAL_BUF_SIZE / 2U,
-                                                             AUDIO_CMD_RECORD);
+      pAudioUserData->AudioCmd (&haudio->in.buff[0],
+                                AUDIO_TOTAL_BUF_SIZE / 2U,
+                                AUDIO_CMD_RECORD);
       haudio->in.wr_ptr = AUDIO_TOTAL_BUF_SIZE / 2U;
     }
 
     if (haudio->in.rd_ptr == 0U)
     {
-      ((USBD_AUDIO_ItfTypeDef *) pdev->pUserData)->AudioCmd (&haudio->in.buff[AUDIO_TOTAL_BUF_SIZE / 2U],
-                                                             AUDIO_TOTAL_BUF_SIZE / 2U,
-                                                             AUDIO_CMD_RECORD);
+      pAudioUserData->AudioCmd (&haudio->in.buff[AUDIO_TOTAL_BUF_SIZE / 2U],
+                                AUDIO_TOTAL_BUF_SIZE / 2U,
+                                AUDIO_CMD_RECORD);
       haudio->in.wr_ptr = 0U;
     }
 
@@ -752,14 +760,14 @@ static uint8_t USBD_AUDIO_DataIn (USBD_HandleTypeDef *pdev, uint8_t epnum)
 static uint8_t USBD_AUDIO_EP0_RxReady (USBD_HandleTypeDef *pdev)
 {
   USBD_AUDIO_HandleTypeDef *haudio;
-  haudio = (USBD_AUDIO_HandleTypeDef*) pdev->pClassData;
+  haudio = pAudioClassData;
 
   if (haudio->control.cmd == AUDIO_REQ_SET_CUR)
   {/* In this driver, to simplify code, only SET_CUR request is managed */
 
     if (haudio->control.unit == AUDIO_OUT_STREAMING_CTRL)
     {
-      ((USBD_AUDIO_ItfTypeDef *) pdev->pUserData)->MuteCtl (haudio->control.data[0]);
+      pAudioUserData->MuteCtl (haudio->control.data[0]);
       haudio->control.cmd = 0U;
       haudio->control.len = 0U;
     }
@@ -843,7 +851,7 @@ static uint8_t USBD_AUDIO_IsoOutIncomplete (USBD_HandleTypeDef *pdev, uint8_t ep
 static uint8_t USBD_AUDIO_DataOut (USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
   USBD_AUDIO_HandleTypeDef *haudio;
-  haudio = (USBD_AUDIO_HandleTypeDef*) pdev->pClassData;
+  haudio = pAudioClassData;
 
   if (epnum == AUDIO_OUT_EP)
   {
@@ -856,9 +864,9 @@ static uint8_t USBD_AUDIO_DataOut (USBD_HandleTypeDef *pdev, uint8_t epnum)
         haudio->out.buff_enable = 1U;
       }
 
-      ((USBD_AUDIO_ItfTypeDef*) pdev->pUserData)->AudioCmd (&haudio->out.buff[0],
-                                                            AUDIO_TOTAL_BUF_SIZE / 2U,
-                                                            AUDIO_CMD_PLAY);
+      pAudioUserData->AudioCmd (&haudio->out.buff[0],
+                                AUDIO_TOTAL_BUF_SIZE / 2U,
+                                AUDIO_CMD_PLAY);
     }
 
     if (haudio->out.wr_ptr == AUDIO_TOTAL_BUF_SIZE)
@@ -866,9 +874,9 @@ static uint8_t USBD_AUDIO_DataOut (USBD_HandleTypeDef *pdev, uint8_t epnum)
       /* All buffers are full: roll back */
       haudio->out.wr_ptr = 0U;
 
-      ((USBD_AUDIO_ItfTypeDef*) pdev->pUserData)->AudioCmd (&haudio->out.buff[AUDIO_TOTAL_BUF_SIZE / 2U],
-                                                            AUDIO_TOTAL_BUF_SIZE / 2U,
-                                                            AUDIO_CMD_PLAY);
+      pAudioUserData->AudioCmd (&haudio->out.buff[AUDIO_TOTAL_BUF_SIZE / 2U],
+                                AUDIO_TOTAL_BUF_SIZE / 2U,
+                                AUDIO_CMD_PLAY);
     }
     /* Prepare Out endpoint to receive next audio packet */
     USBD_LL_PrepareReceive (pdev, AUDIO_OUT_EP, &haudio->out.buff[haudio->out.wr_ptr], AUDIO_OUT_PACKET);
@@ -888,7 +896,7 @@ static uint8_t USBD_AUDIO_DataOut (USBD_HandleTypeDef *pdev, uint8_t epnum)
 static void AUDIO_REQ_GetCurrent (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req)
 {
   USBD_AUDIO_HandleTypeDef *haudio;
-  haudio = (USBD_AUDIO_HandleTypeDef*) pdev->pClassData;
+  haudio = pAudioClassData;
 
   memset (haudio->control.data, 0, 64U);
 
@@ -907,7 +915,7 @@ static void AUDIO_REQ_GetCurrent (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
 static void AUDIO_REQ_SetCurrent (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req)
 {
   USBD_AUDIO_HandleTypeDef *haudio;
-  haudio = (USBD_AUDIO_HandleTypeDef*) pdev->pClassData;
+  haudio = pAudioClassData;
 
   if (req->wLength)
   {
@@ -944,7 +952,7 @@ uint8_t USBD_AUDIO_RegisterInterface (USBD_HandleTypeDef *pdev, USBD_AUDIO_ItfTy
 {
   if(fops != NULL)
   {
-    pdev->pUserData= fops;
+    pAudioUserData = fops;
   }
   return USBD_OK;
 }
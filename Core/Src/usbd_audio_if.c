@@ -21,6 +21,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "dsp_if.h"
+#include "mon_if.h"
 #include "usbd_audio_if.h"
 
 /* USER CODE END INCLUDE */
@@ -89,6 +90,8 @@
 
 /* USER CODE BEGIN PRIVATE_VARIABLES */
 
+AUDIO_Render_TypeDef audio_render;
+
 /* USER CODE END PRIVATE_VARIABLES */
 
 /**
@@ -125,6 +128,8 @@ static int8_t AUDIO_GetState_FS(void);
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
 
+static void AUDIO_Render_Request (uint8_t* pbuf, uint32_t size);
+
 /* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
 
 /**
@@ -176,7 +181,7 @@ static int8_t AUDIO_DeInit_FS(uint32_t options)
   * @param  cmd: Command opcode
   * @retval USBD_OK if all operations are OK else USBD_FAIL
   */
-static int8_t AUDIO_AudioCmd_FS(uint8_t* pbuf, uint32_t size, uint8_t cmd)
+static __HOT_FUNC int8_t AUDIO_AudioCmd_FS(uint8_t* pbuf, uint32_t size, uint8_t cmd)
 {
   /* USER CODE BEGIN 2 */
   switch(cmd)
@@ -193,7 +198,7 @@ static int8_t AUDIO_AudioCmd_FS(uint8_t* pbuf, uint32_t size, uint8_t cmd)
     break;
 
     case AUDIO_CMD_RECORD:
-      DSP_In_Buff_Read (pbuf, size);
+      AUDIO_Render_Request (pbuf, size);
     break;
 
   }
@@ -272,6 +277,66 @@ void HalfTransfer_CallBack_FS(void)
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
+/**
+  * @brief  Requests a USB In packet render
+  *         The packet is rendered by AUDIO_Render_FS () in PendSV, so the
+  *         USB interrupt only swaps the buffer halves. The half is sent one
+  *         packet later: a request still busy by then is an overrun, the
+  *         stale half goes out and its render is dropped
+  * @param  pbuf: Half of USB In buffer
+  * @param  size: Number of bytes to render
+  * @retval None
+  */
+static __HOT_FUNC void AUDIO_Render_Request (uint8_t* pbuf, uint32_t size)
+{
+  /* PendSV has the lowest priority and never preempts this */
+  if (audio_render.busy)
+  {
+    audio_render.overruns++;
+    MON_Overrun ();
+  }
+
+  audio_render.buff = pbuf;
+  audio_render.size = size;
+  audio_render.request++;
+  audio_render.busy = 1U;
+
+  SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+/**
+  * @brief  Renders the requested USB In packet
+  *         It is called by PendSV_Handler ()
+  * @retval None
+  */
+__HOT_FUNC void AUDIO_Render_FS (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint8_t  *buff;
+  uint32_t size;
+  uint32_t request;
+  uint8_t  busy;
+
+  __disable_irq ();
+  buff    = audio_render.buff;
+  size    = audio_render.size;
+  request = audio_render.request;
+  busy    = audio_render.busy;
+  __set_PRIMASK (primask);
+
+  if (!busy) return;
+
+  DSP_In_Buff_Read (buff, size);
+
+  /* A request made meanwhile has pended PendSV again and stays busy */
+  __disable_irq ();
+  if (audio_render.request == request)
+  {
+    audio_render.busy = 0U;
+  }
+  __set_PRIMASK (primask);
+}
+
 /* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
 /**
@@ -87,7 +87,23 @@ USBD_ClassTypeDef  USBD_COMP =
 extern USBD_HandleTypeDef hUsbDeviceFS;
 
 USBD_COMP_ItfTypeDef USBD_COMP_fops_FS;
-USBD_ClassCompInfo comp_dev [CLASS_NUM];
+
+/* Composite device routing table: one row per class.
+ * The CDC class owns pdev->pClassData and pdev->pUserData, the Audio class
+ * keeps its own handle, so no class data is swapped while routing events */
+static const USBD_ClassCompInfo comp_dev [CLASS_NUM] =
+{
+  [VCP] = { &USBD_CDC,   CDC_CTRL_IF,   CDC_DATA_IF, CDC_IN_EP,   CDC_OUT_EP   },
+  [UAC] = { &USBD_AUDIO, AUDIO_CTRL_IF, AUDIO_IN_IF, AUDIO_IN_EP, AUDIO_OUT_EP },
+};
+
+/* Interface and endpoint to class lookup, built from comp_dev at init */
+static uint8_t comp_if_map     [USBD_MAX_NUM_INTERFACES + 1U];
+static uint8_t comp_ep_in_map  [16U];
+static uint8_t comp_ep_out_map [16U];
+
+/* Class which has accepted the data stage of the current control request */
+static uint8_t comp_ep0_class = COMP_NO_CLASS;
 
 
 /* USB COMP device Configuration Descriptor */
@@ -483,16 +499,62 @@ __ALIGN_BEGIN static uint8_t USBD_COMP_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER
 
 /* Private functions ---------------------------------------------------------*/
 
-static inline void switchToClass (USBD_HandleTypeDef *pdev, USBD_ClassCompInfo *class)
+/**
+ * @brief  comp_build_maps
+ *         Builds the interface and endpoint to class lookup tables
+ *         from the composite device routing table
+ */
+
+static void comp_build_maps (void)
 {
-  pdev->pClassData = class->classData;
-  pdev->pUserData  = class->userData;
+  memset (comp_if_map,     COMP_NO_CLASS, sizeof (comp_if_map));
+  memset (comp_ep_in_map,  COMP_NO_CLASS, sizeof (comp_ep_in_map));
+  memset (comp_ep_out_map, COMP_NO_CLASS, sizeof (comp_ep_out_map));
+
+  for (uint8_t i = 0U; i < CLASS_NUM; i++)
+  {
+    for (uint8_t itf = comp_dev[i].minIf; itf <= comp_dev[i].maxIf; itf++)
+    {
+      comp_if_map [itf] = i;
+    }
+
+    comp_ep_in_map  [comp_dev[i].inEp  & 0x0FU] = i;
+    comp_ep_out_map [comp_dev[i].outEp & 0x0FU] = i;
+  }
 }
 
-static inline void saveClass (USBD_HandleTypeDef *pdev, USBD_ClassCompInfo *class)
+/**
+ * @brief  comp_get_class
+ *         Looks up the class which owns the recipient of a control request
+ * @param  req: usb request
+ * @retval class index or COMP_NO_CLASS
+ */
+
+static uint8_t comp_get_class (USBD_SetupReqTypedef *req)
 {
-  class->classData = pdev->pClassData;
-  class->userData  = pdev->pUserData;
+  uint8_t index = LOBYTE (req->wIndex);
+
+  switch (req->bmRequest & USB_REQ_RECIPIENT_MASK)
+  {
+    case USB_REQ_RECIPIENT_INTERFACE:
+      if (index <= USBD_MAX_NUM_INTERFACES)
+      {
+        return comp_if_map [index];
+      }
+      break;
+
+    case USB_REQ_RECIPIENT_ENDPOINT:
+      if (index & 0x80U)
+      {
+        return comp_ep_in_map [index & 0x0FU];
+      }
+      return comp_ep_out_map [index & 0x0FU];
+
+    default:
+      break;
+  }
+
+  return COMP_NO_CLASS;
 }
 
 /**
@@ -516,26 +578,25 @@ static uint8_t USBD_COMP_Init (USBD_HandleTypeDef *pdev, uint8_t cfgidx)
     .datatype   = 8U,    /* Data bits */
   };
 
-  comp_dev[VCP].class    = &USBD_CDC;
-  comp_dev[VCP].userData = &USBD_Interface_fops_FS;
-  comp_dev[VCP].ctrlIf   = CDC_CTRL_IF;
-  comp_dev[VCP].minIf    = CDC_CTRL_IF;
-  comp_dev[VCP].maxIf    = CDC_DATA_IF;
+  comp_build_maps ();
+  comp_ep0_class = COMP_NO_CLASS;
 
-  switchToClass (pdev, &comp_dev[VCP]);
-  retval = comp_dev[VCP].class->Init (pdev, cfgidx);
-  saveClass (pdev, &comp_dev[VCP]);
-  memcpy ((uint8_t*) comp_dev[VCP].classData, &line_coding, sizeof (line_coding));
+  /* CDC class works through pdev->pClassData and pdev->pUserData */
+  pdev->pUserData = &USBD_Interface_fops_FS;
+  USBD_AUDIO_RegisterInterface (pdev, &USBD_AUDIO_fops_FS);
 
-  comp_dev[UAC].class    = &USBD_AUDIO;
-  comp_dev[UAC].userData = &USBD_AUDIO_fops_FS;
-  comp_dev[UAC].ctrlIf   = AUDIO_CTRL_IF;
-  comp_dev[UAC].minIf    = AUDIO_CTRL_IF;
-  comp_dev[UAC].maxIf    = AUDIO_IN_IF;
+  for (uint8_t i = 0U; i < CLASS_NUM; i++)
+  {
+    if (comp_dev[i].class->Init (pdev, cfgidx) != USBD_OK)
+    {
+      retval = USBD_FAIL;
+    }
+  }
 
-  switchToClass (pdev, &comp_dev[UAC]);
-  retval = comp_dev[UAC].class->Init (pdev, cfgidx);
-  saveClass (pdev, &comp_dev[UAC]);
+  if (pdev->pClassData != NULL)
+  {
+    memcpy ((uint8_t*) pdev->pClassData, &line_coding, sizeof (line_coding));
+  }
 
   return retval;
 }
@@ -554,16 +615,14 @@ static uint8_t USBD_COMP_DeInit (USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 
   for (uint8_t i = 0U; i < CLASS_NUM; i++)
   {
-    switchToClass (pdev, &comp_dev[i]);
     retval = comp_dev[i].class->DeInit (pdev, cfgidx);
-    saveClass (pdev, &comp_dev[i]);
   }
   return retval;
 }
 
 /**
  * @brief  USBD_COMP_Setup
- *         Handle the AUDIO specific requests
+ *         Route the control requests to the class owning the recipient
  * @param  pdev: instance
  * @param  req: usb requests
  * @retval status
@@ -574,83 +633,36 @@ static uint8_t USBD_COMP_Setup (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *
   uint16_t len;
   uint8_t  *pbuf;
   uint8_t  retval = USBD_OK;
-  uint8_t  done = 0U;
-  uint8_t  i;
+  uint8_t  i = comp_get_class (req);
 
-  switch (req->bmRequest & USB_REQ_TYPE_MASK)
+  if (((req->bmRequest & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_STANDARD) &&
+       (req->bRequest == USB_REQ_GET_DESCRIPTOR))
   {
-    case USB_REQ_TYPE_CLASS:
-      switch (req->bRequest)
-      {
-        case AUDIO_REQ_GET_CUR:
-        case AUDIO_REQ_SET_CUR:
-
-          switchToClass (pdev, &comp_dev[UAC]);
-          retval = comp_dev[UAC].class->Setup (pdev, req);
-          if (!retval) done = 1U;
-          break;
-
-        case CDC_SET_LINE_CODING:
-        case CDC_GET_LINE_CODING:
-        case CDC_SET_CONTROL_LINE_STATE:
-
-          switchToClass (pdev, &comp_dev[VCP]);
-          retval = comp_dev[VCP].class->Setup (pdev, req);
-          if (!retval) done = 1U;
-          break;
-      }
+    if ((req->wValue >> 8) == AUDIO_DESCRIPTOR_TYPE)
+    {
+      pbuf = USBD_COMP_CfgDesc + 92;
+      len  = MIN (pbuf[0] , req->wLength);
 
-      if (done != 1U)
-      {
-        USBD_CtlError (pdev, req);
-        retval = USBD_FAIL;
-      }
+      USBD_CtlSendData (pdev, pbuf, len);
+    }
+    return retval;
+  }
 
-      break;
+  if (i == COMP_NO_CLASS)
+  {
+    /* Call the error management function (command will be nacked */
+    USBD_CtlError (pdev, req);
+    return USBD_FAIL;
+  }
 
-    case USB_REQ_TYPE_STANDARD:
+  retval = comp_dev[i].class->Setup (pdev, req);
 
-      switch (req->bRequest)
-      {
-        case USB_REQ_GET_DESCRIPTOR:
-
-          if( (req->wValue >> 8) == AUDIO_DESCRIPTOR_TYPE)
-          {
-            pbuf = USBD_COMP_CfgDesc + 92;
-            len  = MIN (pbuf[0] , req->wLength);
-
-            USBD_CtlSendData (pdev, pbuf, len);
-          }
-          break;
-
-        case USB_REQ_GET_INTERFACE:
-        case USB_REQ_SET_INTERFACE:
-
-          if ((uint8_t) (req->wIndex) <= USBD_MAX_NUM_INTERFACES)
-          {
-            for (i = 0U; i < CLASS_NUM; i++)
-            {
-              if ((req->wIndex >= comp_dev[i].minIf) && (req->wIndex <= comp_dev[i].maxIf))
-              {
-                switchToClass (pdev, &comp_dev[i]);
-                retval = comp_dev[i].class->Setup (pdev, req);
-                done = 1U;
-                break;
-              }
-            }
-          }
-          else
-          {
-            /* Call the error management function (command will be nacked */
-            USBD_CtlError (pdev, req);
-          }
-          break;
-
-        default:
-          USBD_CtlError (pdev, req);
-          retval = USBD_FAIL;
-      }
+  if ((retval == USBD_OK) && (req->wLength != 0U) && !(req->bmRequest & 0x80U))
+  {
+    /* Data stage will be delivered to this class via EP0_RxReady */
+    comp_ep0_class = i;
   }
+
   return retval;
 }
 
@@ -664,19 +676,14 @@ static uint8_t USBD_COMP_Setup (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *
 
 static uint8_t  USBD_COMP_DataIn (USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
-  uint8_t retval = USBD_OK;
-  uint8_t i;
-
-  if (epnum == (CDC_IN_EP & 0x7F))   i = VCP;
-  if (epnum == (AUDIO_IN_EP & 0x7F)) i = UAC;
+  uint8_t i = comp_ep_in_map [epnum & 0x0FU];
 
-  if (comp_dev[i].class->DataIn != NULL)
+  if ((i == COMP_NO_CLASS) || (comp_dev[i].class->DataIn == NULL))
   {
-    switchToClass (pdev, &comp_dev[i]);
-    retval = comp_dev[i].class->DataIn (pdev, epnum);
+    return USBD_OK;
   }
 
-  return retval;
+  return comp_dev[i].class->DataIn (pdev, epnum);
 }
 
 /**
@@ -689,19 +696,14 @@ static uint8_t  USBD_COMP_DataIn (USBD_HandleTypeDef *pdev, uint8_t epnum)
 
 static uint8_t  USBD_COMP_DataOut (USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
-  uint8_t retval = USBD_OK;
-  uint8_t i;
+  uint8_t i = comp_ep_out_map [epnum & 0x0FU];
 
-  if (epnum == CDC_OUT_EP)   i = VCP;
-  if (epnum == AUDIO_OUT_EP) i = UAC;
-
-  if (comp_dev[i].class->DataOut != NULL)
+  if ((i == COMP_NO_CLASS) || (comp_dev[i].class->DataOut == NULL))
   {
-    switchToClass (pdev, &comp_dev[i]);
-    retval = comp_dev[i].class->DataOut (pdev, epnum);
+    return USBD_OK;
   }
 
-  return retval;
+  return comp_dev[i].class->DataOut (pdev, epnum);
 }
 
 /**
@@ -719,7 +721,6 @@ static uint8_t  USBD_COMP_SOF (USBD_HandleTypeDef *pdev)
   {
     if (comp_dev[i].class->SOF != NULL)
     {
-      switchToClass (pdev, &comp_dev[i]);
       retval = comp_dev[i].class->SOF (pdev);
     }
   }
@@ -735,17 +736,16 @@ static uint8_t  USBD_COMP_SOF (USBD_HandleTypeDef *pdev)
 
 static uint8_t  USBD_COMP_EP0_RxReady (USBD_HandleTypeDef *pdev)
 {
-  uint8_t retval = USBD_OK;
+  uint8_t i = comp_ep0_class;
 
-  for (uint8_t i = 0U; i < CLASS_NUM; i++)
+  comp_ep0_class = COMP_NO_CLASS;
+
+  if ((i == COMP_NO_CLASS) || (comp_dev[i].class->EP0_RxReady == NULL))
   {
-    if (comp_dev[i].class->EP0_RxReady != NULL)
-    {
-      switchToClass (pdev, &comp_dev[i]);
-      retval = comp_dev[i].class->EP0_RxReady (pdev);
-    }
+    return USBD_OK;
   }
-  return retval;
+
+  return comp_dev[i].class->EP0_RxReady (pdev);
 }
 
 /**
@@ -830,30 +830,5 @@ uint8_t USBD_COMP_RegisterInterface (USBD_HandleTypeDef   *pdev,
 }
 
 
-/**
-  * @brief  CDC_Transmit_FS
-  *         Data to send over USB IN endpoint are sent over CDC interface
-  *         through this function.
-  *         @note
-  *
-  *
-  * @param  Buf: Buffer of data to be sent
-  * @param  Len: Number of data to be sent (in bytes)
-  * @retval USBD_OK if all operations are OK else USBD_FAIL or USBD_BUSY
-  */
-
-uint8_t COMP_CDC_Transmit_FS (uint8_t* Buf, uint16_t Len)
-{
-  uint8_t result = USBD_OK;
-
-  switchToClass (&hUsbDeviceFS, &comp_dev[VCP]);
-
-//  USBD_CDC_SetTxBuffer(&hUsbDeviceFS, Buf, Len);
-//  result = USBD_CDC_TransmitPacket(&hUsbDeviceFS);
-
-  return result;
-}
-
-
 
 /****END OF FILE****/
@@ -22,6 +22,9 @@
 #include "ssd1306.h"
 #include "ptt_if.h"
 #include "cw_gen.h"
+#include "prof_if.h"
+#include "mon_if.h"
+#include "lp_if.h"
 #include <stdio.h>
 
 /* Private typedef -----------------------------------------------------------*/
@@ -32,7 +35,6 @@
 
 /* Private variables ---------------------------------------------------------*/
 
-uint32_t displayed   = 0U;
 uint16_t key_pressed = 0U;
 uint16_t key_value   = 0U;
 
@@ -132,10 +134,10 @@ void ui_set_keyer_pitch (void)
 {
   if (trx.is_tx) return;
 
-  uint8_t keyer_pitch;
+  uint16_t keyer_pitch;
 
-  keyer_pitch = (TIM3->CNT >> 2U) + 3U;
-  sprintf (str, " %d Hz ", keyer_pitch * 100U);
+  keyer_pitch = (TIM3->CNT >> 2U) * CW_PITCH_STEP + CW_PITCH_MIN;
+  sprintf (str, " %d Hz ", keyer_pitch);
 
   switch (key_pressed)
   {
@@ -145,15 +147,38 @@ void ui_set_keyer_pitch (void)
     case 3:
       cw_keyer.pitch = keyer_pitch;
     case 1:
-      sprintf (str, " %d Hz ", cw_keyer.pitch * 100U);
+      sprintf (str, " %d Hz ", cw_keyer.pitch);
       focus = 3U;
       TIM3->ARR = 15U;
       TIM3->CNT = focus << 2U;
-      CW_Set_Pitch (cw_keyer.pitch * 100U, 48000U);
+      CW_Set_Pitch (cw_keyer.pitch, 48000U);
       break;
   }
 }
 
+/**
+  * @brief This function shows CPU and interrupt load of the last window
+  *
+  * CPU load is the time the core did not sleep, see lp_if.c. Interrupt
+  * load is the part of the time spent in interrupt handlers, see
+  * mon_if.c, the entry latency is read by CAT command ZM. "!" is shown
+  * while a budget alarm is latched
+  *
+  */
+
+void ui_show_load (void)
+{
+  char line [20];
+
+  sprintf (line, " CPU%2lu%% IRQ%2lu%% %c ",
+           (unsigned long) ((1000U - lp.idle) / 10U),
+           (unsigned long) (mon.load / 10U),
+           mon.alarm ? '!' : ' ');
+
+  ssd1306_SetCursor (5, 54);
+  ssd1306_WriteString (line, Font_7x10, White);
+}
+
 /* Public functions ----------------------------------------------------------*/
 
 /**
@@ -173,8 +198,6 @@ void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc1)
 
 void UI_Init (void)
 {
-  displayed = trx.sysclock;
-
   HAL_ADC_Start_IT (&hadc1);
   HAL_TIM_Encoder_Start (&htim3, TIM_CHANNEL_ALL);
   TIM3->ARR = 15U;
@@ -186,123 +209,129 @@ void UI_Init (void)
 /**
   * @brief This function handles CW keyer UI events
   *
+  * It is run by the scheduler every UI_REDRAW_TIME ms
+  *
   */
 
 void UI_Handler (void)
 {
-  if ((trx.sysclock - displayed) > 24)
-  {
-    displayed = trx.sysclock;
-    sprintf (str, "         ");
+  PROF_START (PROF_UI);
 
-    if (key_value < 2900) { key_pressed = 0; }
-    if (key_value > 3000) { key_pressed = 1; }
-    if (key_value > 3500) { key_pressed = 2; }
-    if (key_value > 3900) { key_pressed = 3; }
+  sprintf (str, "         ");
 
-    if (focus < 4U)
-    {
-      focus = TIM3->CNT >> 2U;
-    }
+  if (key_value < 2900) { key_pressed = 0; }
+  if (key_value > 3000) { key_pressed = 1; }
+  if (key_value > 3500) { key_pressed = 2; }
+  if (key_value > 3900) { key_pressed = 3; }
 
-    item_color = Black;
+  if (focus < 4U)
+  {
+    focus = TIM3->CNT >> 2U;
+  }
+
+  item_color = Black;
+
+  if (focus == 4U)
+  {
+    ui_set_keyer_mode ();
+  }
+  else
+  {
+    ui_keyer_mode_to_string (cw_keyer.mode);
 
-    if (focus == 4U)
+    if (focus == 1U)
     {
-      ui_set_keyer_mode ();
+      if (key_pressed == 3U)
+      {
+        TIM3->ARR = 15U;
+        TIM3->CNT = cw_keyer.mode << 2U;
+        focus = 4U;
+      }
     }
     else
     {
-      ui_keyer_mode_to_string (cw_keyer.mode);
-
-      if (focus == 1U)
-      {
-        if (key_pressed == 3U)
-        {
-          TIM3->ARR = 15U;
-          TIM3->CNT = cw_keyer.mode << 2U;
-          focus = 4U;
-        }
-      }
-      else
-      {
-        item_color = White;
-      }
+      item_color = White;
     }
+  }
+
+  ssd1306_SetCursor (5, 20);
+  ssd1306_WriteString (" MODE  ", Font_7x10, item_color);
 
-    ssd1306_SetCursor (5, 20);
-    ssd1306_WriteString (" MODE  ", Font_7x10, item_color);
+  ssd1306_SetCursor (54, 20);
+  ssd1306_WriteString (str, Font_7x10, White);
 
-    ssd1306_SetCursor (54, 20);
-    ssd1306_WriteString (str, Font_7x10, White);
+  item_color = Black;
 
-    item_color = Black;
+  if (focus == 5U)
+  {
+    ui_set_keyer_speed ();
+  }
+  else
+  {
+    sprintf (str, " %d WPM ", cw_keyer.speed);
 
-    if (focus == 5U)
+    if (focus == 2U)
     {
-      ui_set_keyer_speed ();
+      if (key_pressed == 3U)
+      {
+        TIM3->ARR = 227U;
+        TIM3->CNT = (cw_keyer.speed - 4U) << 2U;
+        focus = 5U;
+      }
     }
     else
     {
-      sprintf (str, " %d WPM ", cw_keyer.speed);
-
-      if (focus == 2U)
-      {
-        if (key_pressed == 3U)
-        {
-          TIM3->ARR = 227U;
-          TIM3->CNT = (cw_keyer.speed - 4U) << 2U;
-          focus = 5U;
-        }
-      }
-      else
-      {
-        item_color = White;
-      }
+      item_color = White;
     }
+  }
+
+  ssd1306_SetCursor (5, 32);
+  ssd1306_WriteString (" SPEED ", Font_7x10, item_color);
 
-    ssd1306_SetCursor (5, 32);
-    ssd1306_WriteString (" SPEED ", Font_7x10, item_color);
+  ssd1306_SetCursor (54, 32);
+  ssd1306_WriteString (str, Font_7x10, White);
 
-    ssd1306_SetCursor (54, 32);
-    ssd1306_WriteString (str, Font_7x10, White);
 
+  item_color = Black;
 
-    item_color = Black;
+  if (focus == 6U)
+  {
+    ui_set_keyer_pitch ();
+  }
+  else
+  {
+    sprintf (str, " %d Hz ", cw_keyer.pitch);
 
-    if (focus == 6U)
+    if (focus == 3U)
     {
-      ui_set_keyer_pitch ();
+      if (key_pressed == 3U)
+      {
+        TIM3->ARR = (((CW_PITCH_MAX - CW_PITCH_MIN) / CW_PITCH_STEP) << 2U) + 3U;
+        TIM3->CNT = ((cw_keyer.pitch - CW_PITCH_MIN) / CW_PITCH_STEP) << 2U;
+        focus = 6U;
+      }
     }
     else
     {
-      sprintf (str, " %d Hz ", cw_keyer.pitch * 100U);
-
-      if (focus == 3U)
-      {
-        if (key_pressed == 3U)
-        {
-          TIM3->ARR = 31U;
-          TIM3->CNT = (cw_keyer.pitch - 3U) << 2U;
-          focus = 6U;
-        }
-      }
-      else
-      {
-        item_color = White;
-      }
+      item_color = White;
     }
+  }
 
-    ssd1306_SetCursor (5, 44);
-    ssd1306_WriteString (" PITCH ", Font_7x10, item_color);
+  ssd1306_SetCursor (5, 44);
+  ssd1306_WriteString (" PITCH ", Font_7x10, item_color);
 
-    ssd1306_SetCursor (54, 44);
-    ssd1306_WriteString (str, Font_7x10, White);
+  ssd1306_SetCursor (54, 44);
+  ssd1306_WriteString (str, Font_7x10, White);
 
-    HAL_ADC_Start_IT (&hadc1);
+  ui_show_load ();
 
-    ssd1306_UpdateScreen ();
-  }
+  HAL_ADC_Start_IT (&hadc1);
+
+  PROF_START (PROF_DISPLAY);
+  ssd1306_UpdateScreen ();
+  PROF_STOP (PROF_DISPLAY);
+
+  PROF_STOP (PROF_UI);
 }
 
 /****END OF FILE****/
@@ -0,0 +1,524 @@
+/**
+  *******************************************************************************
+  *
+  * @file    wk_if.c
+  * @brief   WinKeyer Interface
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  *
+  * The module emulates K1EL WinKeyer WK2 host mode on the CDC port.
+  * The text is sent by the on-device CW encoder of cw_gen.c
+  *
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "wk_if.h"
+#include "cw_gen.h"
+#include "ptt_if.h"
+#include "usbd_cdc_if.h"
+#include "usbd_audio.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+WK_TypeDef wk;
+
+/* Number of arguments of host mode commands 0x00...0x1F */
+
+static const uint8_t wk_cmd_args [32] =
+{
+  1, 1, 1, 1, 2, 3, 1, 0,  0, 1, 0, 1, 1, 1, 1, 15,
+  1, 1, 1, 0, 1, 0, 1, 1,  1, 1, 1, 2, 1, 1, 0, 0
+};
+
+/* Number of arguments of admin commands 0x00...0x1F */
+
+static const uint8_t wk_admin_args [32] =
+{
+  1, 0, 0, 0, 1, 0, 0, 0,  0, 0, 0, 0, 0, 0, 1, 1,
+  0, 0, 0, 2, 0, 0, 1, 0,  0, 1, 0, 0, 0, 0, 0, 0
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+extern PTT_TypeDef ptt;
+extern CW_Keyer    cw_keyer;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function sends WinKeyer answer
+ *
+ * @param Answer byte
+ */
+
+static void wk_reply (uint8_t byte)
+{
+  CDC_Write_FS (&byte, 1U);
+}
+
+/**
+ * @brief This function returns WinKeyer status byte
+ *
+ */
+
+static uint8_t wk_get_status (void)
+{
+  uint8_t status = WK_STATUS;
+
+  if (CW_Text_Pending ())
+  {
+    status |= WK_STATUS_BUSY;
+  }
+
+  if (ptt.key_dit_is_on || ptt.key_dah_is_on)
+  {
+    status |= WK_STATUS_BREAKIN;
+  }
+
+  if (CW_Text_Free () < WK_XOFF_FREE)
+  {
+    status |= WK_STATUS_XOFF;
+  }
+
+  return status;
+}
+
+/**
+ * @brief This function returns speed pot byte
+ *
+ * The speed set by the encoder works as WinKeyer speed pot
+ *
+ */
+
+static uint8_t wk_get_pot (void)
+{
+  uint8_t pot = 0U;
+
+  if (cw_keyer.speed > wk.values [WK_VAL_POT_MIN])
+  {
+    pot = cw_keyer.speed - wk.values [WK_VAL_POT_MIN];
+  }
+
+  if (pot > wk.values [WK_VAL_POT_RANGE])
+  {
+    pot = wk.values [WK_VAL_POT_RANGE];
+  }
+
+  return WK_SPEED_POT | (pot & 0x3FU);
+}
+
+/**
+ * @brief This function sets keyer mode from WinKeyer mode register
+ *
+ * Key mode bits have the same order as keyer modes of cw_gen.h,
+ * bug mode is sent as straight key
+ *
+ */
+
+static void wk_set_mode (uint8_t mode)
+{
+  wk.values [WK_VAL_MODE] = mode;
+
+  cw_keyer.mode = (mode & WK_MODE_KEYER_MASK) >> 4U;
+  CW_Set_Keyer ();
+}
+
+/**
+ * @brief This function sets keyer speed
+ *
+ * @param Speed in WPM, 0 - use speed pot
+ */
+
+static void wk_set_speed (uint8_t speed)
+{
+  wk.values [WK_VAL_SPEED] = speed;
+
+  if (speed == 0U) return;
+
+  if (speed < 4U)  speed = 4U;
+  if (speed > 60U) speed = 60U;
+
+  cw_keyer.speed = speed;
+  wk.speed       = speed;
+  CW_Set_Speed ();
+}
+
+/**
+ * @brief This function sets sidetone pitch
+ *
+ * @param Divider of 62500 Hz
+ */
+
+static void wk_set_sidetone (uint8_t n)
+{
+  uint32_t pitch;
+
+  wk.values [WK_VAL_SIDETONE] = n;
+
+  /* Bit 7 is paddle only sidetone */
+  n &= 0x7FU;
+
+  if (n == 0U) return;
+
+  pitch = (WK_SIDETONE_CLOCK + n / 2U) / n;
+
+  if (pitch < CW_PITCH_MIN) pitch = CW_PITCH_MIN;
+  if (pitch > CW_PITCH_MAX) pitch = CW_PITCH_MAX;
+
+  cw_keyer.pitch = pitch;
+  CW_Set_Pitch (cw_keyer.pitch, USBD_AUDIO_FREQ);
+}
+
+/**
+ * @brief This function puts a character to CW encoder buffer
+ *
+ * @param Character
+ */
+
+static void wk_put_char (char c)
+{
+  if (wk.overwrite)
+  {
+    if (CW_Text_Overwrite (wk.in_ptr, c))
+    {
+      wk.in_ptr++;
+      return;
+    }
+
+    /* Overwrite beyond the end of the text works like append */
+    wk.overwrite = 0U;
+  }
+
+  CW_Text_Write (&c, 1U);
+}
+
+/**
+ * @brief This function clears the text and buffer pointers
+ *
+ */
+
+static void wk_clear_buff (void)
+{
+  CW_Text_Clear ();
+
+  wk.base      = CW_Text_Input_Ptr ();
+  wk.overwrite = 0U;
+}
+
+/**
+ * @brief This function executes admin commands
+ *
+ */
+
+static void wk_admin (void)
+{
+  wk.admin = 0U;
+
+  switch (wk.cmd)
+  {
+    case WK_ADMIN_RESET:
+      WK_Init ();
+      break;
+    case WK_ADMIN_OPEN:
+      wk.is_open = 1U;
+      wk.status  = wk_get_status ();
+      wk.speed   = cw_keyer.speed;
+      wk_clear_buff ();
+      wk_reply (WK_VERSION);
+      break;
+    case WK_ADMIN_CLOSE:
+      wk.is_open = 0U;
+      wk_clear_buff ();
+      PTT_Tune_TX (0U);
+      PTT_CAT_TX (0U);
+      break;
+    case WK_ADMIN_ECHO:
+      wk_reply (wk.args [0]);
+      break;
+    case WK_ADMIN_GET_VALUES:
+      CDC_Write_FS (wk.values, WK_ARGS_SIZE);
+      break;
+    case WK_ADMIN_GET_VERSION:
+      wk_reply (WK_VERSION);
+      break;
+    case 0x05U:   /* Paddle A2D */
+    case 0x06U:   /* Speed A2D */
+    case 0x15U:   /* Read back Vcc */
+    case 0x17U:   /* Get FW minor revision */
+    case 0x18U:   /* Get IC type */
+      wk_reply (0U);
+      break;
+    default:
+      /* Calibration, EEPROM, baud rate and WK1/WK2/WK3 mode
+       * commands have no meaning for the USB device */
+      break;
+  }
+}
+
+/**
+ * @brief This function executes host mode commands
+ *
+ */
+
+static void wk_execute (void)
+{
+  wk.args_need = 0U;
+
+  if (wk.admin)
+  {
+    wk_admin ();
+    return;
+  }
+
+  switch (wk.cmd)
+  {
+    case WK_ADMIN:
+      wk.admin     = 1U;
+      wk.cmd       = wk.args [0] & 0x1FU;
+      wk.args_len  = 0U;
+      wk.args_need = wk_admin_args [wk.cmd];
+
+      if (wk.cmd == WK_ADMIN_LOAD_EEPROM)
+      {
+        wk.skip = WK_EEPROM_SIZE;
+      }
+
+      if (wk.args_need == 0U)
+      {
+        wk_admin ();
+      }
+      break;
+    case WK_SIDETONE:
+      wk_set_sidetone (wk.args [0]);
+      break;
+    case WK_SPEED:
+      wk_set_speed (wk.args [0]);
+      break;
+    case WK_POT_SETUP:
+      wk.values [WK_VAL_POT_MIN]   = wk.args [0];
+      wk.values [WK_VAL_POT_RANGE] = wk.args [1];
+      break;
+    case WK_PAUSE:
+      CW_Text_Pause (wk.args [0]);
+      break;
+    case WK_GET_POT:
+      wk_reply (wk_get_pot ());
+      break;
+    case WK_BACKSPACE:
+      CW_Text_Backspace ();
+      break;
+    case WK_CLEAR_BUFF:
+      wk_clear_buff ();
+      CW_Text_Pause (0U);
+      break;
+    case WK_KEY_IMMEDIATE:
+      PTT_Tune_TX (wk.args [0] != 0U);
+      break;
+    case WK_MODE:
+      wk_set_mode (wk.args [0]);
+      break;
+    case WK_LOAD_DEFAULTS:
+      for (uint32_t i = 0U; i < WK_ARGS_SIZE; i++)
+      {
+        wk.values [i] = wk.args [i];
+      }
+
+      wk_set_mode (wk.values [WK_VAL_MODE]);
+      wk_set_speed (wk.values [WK_VAL_SPEED]);
+      wk_set_sidetone (wk.values [WK_VAL_SIDETONE]);
+      break;
+    case WK_GET_STATUS:
+      wk_reply (wk_get_status ());
+      break;
+    case WK_POINTER:
+      if ((wk.args_len == 1U) && (wk.args [0] != WK_POINTER_RESET))
+      {
+        /* Other pointer commands have one more argument */
+        wk.args_need = 2U;
+        break;
+      }
+
+      switch (wk.args [0])
+      {
+        case WK_POINTER_RESET:
+          wk_clear_buff ();
+          break;
+        case WK_POINTER_OVERWRITE:
+          wk.overwrite = 1U;
+          wk.in_ptr    = wk.base + wk.args [1];
+          break;
+        case WK_POINTER_APPEND:
+          wk.overwrite = 0U;
+          break;
+        case WK_POINTER_NULLS:
+          for (uint32_t i = 0U; i < wk.args [1]; i++)
+          {
+            wk_put_char ('\0');
+          }
+          break;
+        default:
+          break;
+      }
+      break;
+    case WK_PTT:
+      PTT_CAT_TX (wk.args [0] != 0U);
+      break;
+    case WK_MERGE:
+      wk_put_char (wk.args [0]);
+      wk_put_char (wk.args [1]);
+      break;
+    default:
+      /* Weighting, timing and buffered speed commands are not supported */
+      break;
+  }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+ * @brief This function checks if WinKeyer owns the CDC data
+ *
+ * @retval 1 if host mode is open or a command is being received
+ */
+
+uint8_t WK_Is_Active (void)
+{
+  return wk.is_open || (wk.args_need != 0U) || (wk.skip != 0U);
+}
+
+/**
+ * @brief This function parses WinKeyer host data
+ *
+ * Bytes 0x00...0x1F are commands, other bytes are the text to send
+ *
+ * @param Received byte
+ */
+
+void WK_Parse_Byte (uint8_t byte)
+{
+  if (wk.skip)
+  {
+    wk.skip--;
+    return;
+  }
+
+  if (wk.args_need)
+  {
+    wk.args [wk.args_len++] = byte;
+
+    if (wk.args_len == wk.args_need)
+    {
+      wk_execute ();
+    }
+    return;
+  }
+
+  if (byte < 0x20U)
+  {
+    wk.cmd       = byte;
+    wk.admin     = 0U;
+    wk.args_len  = 0U;
+    wk.args_need = wk_cmd_args [byte];
+
+    if (wk.args_need == 0U)
+    {
+      wk_execute ();
+    }
+    return;
+  }
+
+  if (wk.is_open)
+  {
+    wk_put_char ((char) byte);
+  }
+}
+
+/**
+ * @brief This function echoes characters sent by the CW encoder
+ *
+ * It is called in audio interrupt context
+ *
+ * @param Character
+ */
+
+__HOT_FUNC void CW_Text_Sent_Callback (char c)
+{
+  if (wk.is_open && (wk.values [WK_VAL_MODE] & WK_MODE_SERIAL_ECHO))
+  {
+    CDC_Write_FS ((uint8_t*) &c, 1U);
+  }
+}
+
+/**
+ * @brief This function initialize WinKeyer interface
+ *
+ */
+
+void WK_Init (void)
+{
+  for (uint32_t i = 0U; i < WK_ARGS_SIZE; i++)
+  {
+    wk.values [i] = 0U;
+  }
+
+  wk.values [WK_VAL_SPEED]     = cw_keyer.speed;
+  wk.values [WK_VAL_POT_MIN]   = 4U;
+  wk.values [WK_VAL_POT_RANGE] = 56U;
+
+  wk.is_open   = 0U;
+  wk.args_need = 0U;
+  wk.skip      = 0U;
+  wk.admin     = 0U;
+
+  wk_clear_buff ();
+}
+
+/**
+ * @brief This function sends status and speed pot changes to the host
+ *
+ * It is called from the main loop
+ *
+ */
+
+void WK_Handler (void)
+{
+  uint8_t status;
+
+  if (!wk.is_open) return;
+
+  status = wk_get_status ();
+
+  if (wk.status != status)
+  {
+    wk.status = status;
+    wk_reply (status);
+  }
+
+  if (wk.speed != cw_keyer.speed)
+  {
+    wk.speed = cw_keyer.speed;
+    wk_reply (wk_get_pot ());
+  }
+}
+
+/****END OF FILE****/
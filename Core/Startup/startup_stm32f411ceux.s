@@ -40,6 +40,13 @@ defined in linker script */
 .word  _sdata
 /* end address for the .data section. defined in linker script */
 .word  _edata
+/* start address for the initialization values of the .hot section.
+defined in linker script */
+.word  _sihot
+/* start address for the .hot section. defined in linker script */
+.word  _shot
+/* end address for the .hot section. defined in linker script */
+.word  _ehot
 /* start address for the .bss section. defined in linker script */
 .word  _sbss
 /* end address for the .bss section. defined in linker script */
@@ -77,6 +84,23 @@ LoopCopyDataInit:
   adds r4, r0, r3
   cmp r4, r1
   bcc CopyDataInit
+
+/* Copy the audio hot path from flash to SRAM */
+  ldr r0, =_shot
+  ldr r1, =_ehot
+  ldr r2, =_sihot
+  movs r3, #0
+  b LoopCopyHotInit
+
+CopyHotInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyHotInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyHotInit
   
 /* Zero fill the bss segment. */
   ldr r2, =_sbss
@@ -0,0 +1,136 @@
+/**
+  *******************************************************************************
+  *
+  * @file    bench_cw.c
+  * @brief   Host microbenchmark of CW_Handler
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *
+  * Reports the time per stereo sample of the record path
+  * (DSP_In_Buff_Read with CW_Handler) in the keyer modes.
+  *
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "host_stub.h"
+#include "cw_gen.h"
+#include "ptt_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct
+{
+  const char *name;
+  void (*setup) (void);
+} BENCH_TypeDef;
+
+/* Private define ------------------------------------------------------------*/
+
+#define BENCH_BLOCKS        20000U   /* 20 s of audio */
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+static int16_t block [HOST_BLOCK_SIZE];
+
+/* External variables --------------------------------------------------------*/
+
+extern CW_Keyer cw_keyer;
+extern PTT_TypeDef ptt;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void setup_idle (void)
+{
+}
+
+static void setup_straight (void)
+{
+  cw_keyer.mode = STRAIGHT;
+  CW_Set_Keyer ();
+
+  ptt.key_dit_is_on = 1U;
+}
+
+static void setup_iambic (void)
+{
+  ptt.key_dit_is_on = 1U;
+  ptt.key_dah_is_on = 1U;
+}
+
+static void setup_text (void)
+{
+  static const char text [] = "PARIS PARIS PARIS PARIS PARIS PARIS PARIS ";
+
+  CW_Text_Write (text, sizeof (text) - 1U);
+}
+
+static void setup_iq (void)
+{
+  CW_Set_IQ (1U, 12000, 0U);
+  CW_Set_IQ_Balance (10, 50);
+
+  cw_keyer.mode = STRAIGHT;
+  CW_Set_Keyer ();
+
+  ptt.key_dit_is_on = 1U;
+}
+
+static const BENCH_TypeDef benches [] =
+{
+  { "idle",     setup_idle     },
+  { "straight", setup_straight },
+  { "iambic",   setup_iambic   },
+  { "text",     setup_text     },
+  { "iq",       setup_iq       },
+};
+
+/**
+ * @brief The application entry point
+ *
+ */
+
+int main (void)
+{
+  struct timespec start, stop;
+
+  for (uint32_t n = 0U; n < sizeof (benches) / sizeof (benches [0]); n++)
+  {
+    double ns;
+
+    HOST_Init ();
+    benches [n].setup ();
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+
+    for (uint32_t k = 0U; k < BENCH_BLOCKS; k++)
+    {
+      HOST_Audio_Block (block);
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &stop);
+
+    ns = (double) (stop.tv_sec - start.tv_sec) * 1e9 + (double) (stop.tv_nsec - start.tv_nsec);
+
+    printf ("%-10s %8.2f ns/sample\n", benches [n].name, ns / (BENCH_BLOCKS * HOST_BLOCK_SAMPLES));
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/****END OF FILE****/
@@ -0,0 +1,321 @@
+/**
+  *******************************************************************************
+  *
+  * @file    bench_timing.c
+  * @brief   PARIS timing accuracy benchmark of the keyer
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *
+  * At every speed from TIMING_WPM_MIN to TIMING_WPM_MAX the keyer sends
+  * PARIS words and then random text. Marks and gaps are measured at the
+  * half level crossings of the TX envelope and sorted by their nearest
+  * ideal length: dit and dah, element, character and word gap of 1, 3
+  * and 7 dits. The table shows per speed:
+  *
+  *   dit ... word  mean error against ideal timing, ms
+  *   key dit       key line dit length minus ideal dit, ms, this is
+  *                 the CW_SMOOTH_STEPS correction the keyer adds to marks
+  *   wpm           speed from the PARIS word period, its error and limit, %
+  *   worst         worst single mark or gap error, ms and % of a dit
+  *
+  * The limits come from the keyer time step, one 1 ms audio block, not
+  * from the results. The benchmark fails if any speed is over them:
+  *
+  *   worst   3 steps: the length is rounded down to whole steps by
+  *           CW_Set_Speed (), a mark or gap starts on a step boundary,
+  *           and the edge correction CW_SMOOTH_STEPS is in whole steps
+  *           while the shaped edge is not
+  *   wpm     TIMING_WORD_STEPS rounded lengths in a PARIS word, each up
+  *           to one step short, against 50 dits: 35 * WPM / 600 %, from
+  *           0.3% at 5 WPM to 4.7% at 80 WPM
+  *
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "host_stub.h"
+#include "cw_gen.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct
+{
+  double   sum;         /* Error sum, ms */
+  double   worst;       /* Worst absolute error, ms */
+  uint32_t count;
+} TIMING_Stat_TypeDef;
+
+/* Private define ------------------------------------------------------------*/
+
+#define TIMING_WPM_MIN        5U
+#define TIMING_WPM_MAX        80U
+#define TIMING_PARIS_WORDS    5U
+#define TIMING_RANDOM_WORDS   20U
+#define TIMING_SEED           0x5E1E7E00U
+
+#define TIMING_HALF           (CW_TX_LEVEL / 2)   /* Envelope half level */
+#define TIMING_TEXT_SIZE      512U
+#define TIMING_WORDS_MAX      64U
+
+#define TIMING_STEP           1.0     /* Keyer time step, ms */
+#define TIMING_WORST_TOL      (3.0 * TIMING_STEP)   /* Worst mark or gap error limit, ms */
+
+/* Rounded lengths in PARIS: 14 marks, 14 pauses, 5 character gaps and
+ * the word gap of 2 character gaps */
+#define TIMING_WORD_STEPS     35.0
+#define TIMING_WORD_DITS      50.0
+
+#define TIMING_DIT            0U
+#define TIMING_DAH            1U
+#define TIMING_GAP            2U      /* Between elements */
+#define TIMING_CHAR           3U      /* Between characters */
+#define TIMING_WORD           4U      /* Between words */
+#define TIMING_CLASSES        5U
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+static const double timing_units [TIMING_CLASSES] = { 1.0, 3.0, 1.0, 3.0, 7.0 };
+
+/* Characters with a Morse code */
+static const char timing_chars [] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789/?=,.";
+
+static TIMING_Stat_TypeDef stat [TIMING_CLASSES];
+
+static char     text [TIMING_TEXT_SIZE];
+static double   word_start [TIMING_WORDS_MAX];
+static uint32_t words;
+static uint32_t seed;
+
+static int16_t  block [HOST_BLOCK_SIZE];
+
+/* External variables --------------------------------------------------------*/
+
+extern CW_Keyer cw_keyer;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function returns the next pseudo random number
+ *
+ */
+
+static uint32_t timing_random (void)
+{
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+
+  return seed;
+}
+
+/**
+ * @brief This function makes PARIS words and random text after them
+ *
+ * @retval Text length
+ */
+
+static uint32_t timing_text (void)
+{
+  uint32_t len = 0U;
+
+  for (uint32_t w = 0U; w < TIMING_PARIS_WORDS; w++)
+  {
+    memcpy (&text [len], "PARIS ", 6U);
+    len += 6U;
+  }
+
+  for (uint32_t w = 0U; w < TIMING_RANDOM_WORDS; w++)
+  {
+    uint32_t chars = 1U + timing_random () % 6U;
+
+    for (uint32_t c = 0U; c < chars; c++)
+    {
+      text [len++] = timing_chars [timing_random () % (sizeof (timing_chars) - 1U)];
+    }
+
+    text [len++] = ' ';
+  }
+
+  return len;
+}
+
+/**
+ * @brief This function sorts a mark or a gap and adds its error
+ *
+ * @param Length, ms
+ * @param 1 = mark, 0 = gap
+ * @param Ideal dit, ms
+ */
+
+static void timing_add (double len, uint8_t mark, double dit)
+{
+  double  units = len / dit;
+  uint8_t class;
+
+  if (mark)
+  {
+    class = (units < 2.0) ? TIMING_DIT : TIMING_DAH;
+  }
+  else
+  {
+    class = (units < 2.0) ? TIMING_GAP : (units < 5.0) ? TIMING_CHAR : TIMING_WORD;
+  }
+
+  len -= timing_units [class] * dit;
+
+  stat [class].sum += len;
+  stat [class].count++;
+
+  if (fabs (len) > stat [class].worst)
+  {
+    stat [class].worst = fabs (len);
+  }
+}
+
+/**
+ * @brief This function sends the text at one speed and measures it
+ *
+ * @param Speed, WPM
+ */
+
+static void timing_run (uint8_t speed)
+{
+  double   dit = 1200.0 / speed;
+  double   edge = 0.0;
+  uint32_t len = timing_text (), sent = 0U;
+  uint32_t sample = 0U, idle = 0U;
+  int32_t  prev = 0;
+  uint8_t  on = 0U, started = 0U;
+
+  memset (stat, 0, sizeof (stat));
+  words = 0U;
+
+  HOST_Init ();
+
+  cw_keyer.speed = speed;
+  CW_Set_Keyer ();
+  CW_Set_Route (CW_ROUTE_TX_I, CW_ROUTE_TX_Q);
+
+  /* Until the text is out and the last word gap has passed */
+  while (sent < len || CW_Text_Pending () || idle < (uint32_t) (8.0 * dit * CW_SAMPLES_PER_MS))
+  {
+    if (sent < len)
+    {
+      sent += CW_Text_Write (&text [sent], (uint16_t) (len - sent));
+    }
+
+    HOST_Audio_Block (block);
+
+    for (uint32_t i = 0U; i < HOST_BLOCK_SIZE; i += 2U, sample++)
+    {
+      int32_t env = (int32_t) lround (hypot (block [i], block [i + 1U]));
+
+      if ((env >= TIMING_HALF) != on)
+      {
+        /* Half level crossing between two samples, ms */
+        double t = (sample - 1U + (double) (TIMING_HALF - prev) / (env - prev)) / CW_SAMPLES_PER_MS;
+
+        on = !on;
+
+        if (started)
+        {
+          timing_add (t - edge, !on, dit);
+        }
+
+        /* A mark after a word gap starts a word */
+        if (on && (!started || (t - edge) > 5.0 * dit))
+        {
+          if (words < TIMING_WORDS_MAX)
+          {
+            word_start [words++] = t;
+          }
+        }
+
+        started = 1U;
+        edge    = t;
+      }
+
+      idle = on ? 0U : idle + 1U;
+      prev = env;
+    }
+  }
+}
+
+/**
+ * @brief The application entry point
+ *
+ */
+
+int main (void)
+{
+  uint32_t failed = 0U;
+  double   worst_all = 0.0, wpm_all = 0.0;
+
+  seed = TIMING_SEED;
+
+  printf ("  WPM    dit    dah    gap   char   word key dit    wpm  error  limit  worst  worst\n");
+  printf ("                    error, ms                 +ms             %%      %%     ms  %% dit\n");
+
+  for (uint8_t speed = TIMING_WPM_MIN; speed <= TIMING_WPM_MAX; speed++)
+  {
+    double dit = 1200.0 / speed;
+    double key_dit, wpm, wpm_error, worst = 0.0;
+    double wpm_tol = 100.0 * TIMING_WORD_STEPS * TIMING_STEP / (TIMING_WORD_DITS * dit);
+
+    timing_run (speed);
+
+    /* The first element of PARIS is a dit */
+    key_dit = (host.edge [1].time - host.edge [0].time) / 1000.0 - dit;
+    wpm       = 60000.0 * TIMING_PARIS_WORDS / (word_start [TIMING_PARIS_WORDS] - word_start [0]);
+    wpm_error = 100.0 * (wpm - speed) / speed;
+
+    printf ("%5u", speed);
+
+    for (uint32_t c = 0U; c < TIMING_CLASSES; c++)
+    {
+      printf (" %6.2f", stat [c].count ? stat [c].sum / stat [c].count : 0.0);
+
+      if (stat [c].worst > worst)
+      {
+        worst = stat [c].worst;
+      }
+    }
+
+    printf (" %7.2f %6.2f %6.2f %6.2f %6.2f %6.1f", key_dit, wpm, wpm_error, wpm_tol, worst, 100.0 * worst / dit);
+
+    if ((worst > TIMING_WORST_TOL) || (fabs (wpm_error) > wpm_tol))
+    {
+      printf ("  FAIL");
+      failed++;
+    }
+
+    printf ("\n");
+
+    worst_all = fmax (worst_all, worst);
+    wpm_all   = fmax (wpm_all, fabs (wpm_error) / wpm_tol);
+  }
+
+  printf ("\nWorst error %.2f ms, speed error up to %.0f%% of its limit, %u of %u speeds over the limits "
+          "(%.1f ms, %.0f steps per PARIS word)\n",
+          worst_all, 100.0 * wpm_all, failed, TIMING_WPM_MAX - TIMING_WPM_MIN + 1U, TIMING_WORST_TOL, TIMING_WORD_STEPS);
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/****END OF FILE****/
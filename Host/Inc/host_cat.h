@@ -0,0 +1,79 @@
+/**
+  *******************************************************************************
+  *
+  * @file    host_cat.h
+  * @brief   Header for host_cat.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HOST_CAT_H_
+#define HOST_CAT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+void HOST_CAT_Init (void);
+void HOST_CAT_Write (const uint8_t*, uint32_t);
+void HOST_CAT_Clear (void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#define HOST_CAT_REPLY_SIZE    256U
+#define HOST_CAT_TEXT_SIZE     256U
+#define HOST_CAT_KEY_LOG_SIZE  16U
+
+typedef struct
+{
+  uint32_t stamp;       /* CW_Remote_Key () time stamp, us */
+  uint8_t  key;
+} HOST_CAT_Key_TypeDef;
+
+typedef struct
+{
+  uint8_t  reply [HOST_CAT_REPLY_SIZE];   /* CDC_Write_FS () data */
+  uint32_t reply_len;
+  char     text [HOST_CAT_TEXT_SIZE];     /* CW_Text_Write () data */
+  uint32_t text_len;
+  uint32_t text_free;                     /* CW_Text_Free () value */
+  uint32_t speed_sets;                    /* CW_Set_Speed () calls */
+  uint32_t keyer_sets;                    /* CW_Set_Keyer () calls */
+  uint32_t text_clears;                   /* CW_Text_Clear () calls */
+  HOST_CAT_Key_TypeDef key [HOST_CAT_KEY_LOG_SIZE];  /* CW_Remote_Key () calls */
+  uint32_t keys;
+  uint32_t remote_delay;                  /* CW_Remote_Set_Delay () value */
+  uint8_t  export;                        /* EVT_Set_Export () value */
+  uint32_t seq_ptt;                       /* SEQ_PTT () calls */
+} HOST_CAT_TypeDef;
+
+extern HOST_CAT_TypeDef host_cat;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_CAT_H_ */
@@ -0,0 +1,72 @@
+/**
+  *******************************************************************************
+  *
+  * @file    host_stub.h
+  * @brief   Header for host_stub.c file
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HOST_STUB_H_
+#define HOST_STUB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "stm32f4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+void HOST_Init (void);
+void HOST_Audio_Block (int16_t*);
+
+/* Private defines -----------------------------------------------------------*/
+
+#define HOST_BLOCK_SAMPLES     48U                          /* 1 ms at 48 kHz */
+#define HOST_BLOCK_SIZE        (HOST_BLOCK_SAMPLES * 2U)    /* Stereo values */
+#define HOST_BLOCK_TIME        1000U                        /* us */
+#define HOST_EDGE_LOG_SIZE     4096U
+
+typedef struct
+{
+  uint32_t time;        /* Key out time, us */
+  uint8_t  key;
+} HOST_Edge_TypeDef;
+
+typedef struct
+{
+  uint32_t time_us;         /* TIME_Get_Us () value */
+  uint32_t key_on;          /* PTT_Key_On () calls */
+  uint32_t key_off_time;    /* PTT_Key_Off_Time () calls */
+  uint32_t events;          /* EVT_Put_Time () calls */
+  HOST_Edge_TypeDef edge [HOST_EDGE_LOG_SIZE];  /* SEQ_Key () calls */
+  uint32_t edges;
+} HOST_TypeDef;
+
+extern HOST_TypeDef host;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STUB_H_ */
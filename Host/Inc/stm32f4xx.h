@@ -0,0 +1,2 @@
+/* Host stand-in, everything is in stm32f4xx_hal.h */
+#include "stm32f4xx_hal.h"
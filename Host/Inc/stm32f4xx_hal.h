@@ -0,0 +1,151 @@
+/**
+  *******************************************************************************
+  *
+  * @file    stm32f4xx_hal.h
+  * @brief   Host stand-in for the STM32F4 HAL header
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *
+  * Only the types, macros and functions used by the DSP and keyer core
+  * and by the CAT parsers are defined here, so they build and run on
+  * a Linux host.
+  *
+  *******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HOST_STM32F4XX_HAL_H_
+#define HOST_STM32F4XX_HAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum
+{
+  HAL_OK      = 0x00U,
+  HAL_ERROR   = 0x01U,
+  HAL_BUSY    = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+  GPIO_PIN_RESET = 0U,
+  GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef enum
+{
+  EXTI0_IRQn = 6,
+  EXTI1_IRQn = 7
+} IRQn_Type;
+
+typedef struct
+{
+  uint32_t ODR;
+  uint32_t IDR;
+  uint32_t BSRR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t CNT;
+} TIM_TypeDef;
+
+typedef struct
+{
+  TIM_TypeDef *Instance;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t dummy;
+} PCD_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t CYCCNT;
+} DWT_Type;
+
+/* Exported constants --------------------------------------------------------*/
+
+#define __IO                volatile
+#define __weak              __attribute__((weak))
+#define __ALIGN_BEGIN
+#define __ALIGN_END         __attribute__((aligned (4)))
+#define __STATIC_INLINE     static inline
+#define UNUSED(X)           (void) X
+
+/* There are no flash wait states on the host, the hot path stays in place */
+#define HOT_RAM             0
+
+#define GPIO_PIN_0          ((uint16_t) 0x0001)
+#define GPIO_PIN_1          ((uint16_t) 0x0002)
+#define GPIO_PIN_2          ((uint16_t) 0x0004)
+#define GPIO_PIN_13         ((uint16_t) 0x2000)
+
+extern GPIO_TypeDef host_gpio [3];
+
+#define GPIOA               (&host_gpio [0])
+#define GPIOB               (&host_gpio [1])
+#define GPIOC               (&host_gpio [2])
+
+/* The cycle counter of the interrupt monitor stays at 0 */
+extern DWT_Type host_dwt;
+
+#define DWT                 (&host_dwt)
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+void HAL_GPIO_WritePin (GPIO_TypeDef*, uint16_t, GPIO_PinState);
+GPIO_PinState HAL_GPIO_ReadPin (GPIO_TypeDef*, uint16_t);
+uint32_t HAL_GetTick (void);
+void HAL_Delay (uint32_t);
+
+/* Interrupts are not used on the host, the mask is kept for the core only */
+
+extern uint32_t host_primask;
+
+static inline uint32_t __get_PRIMASK (void)
+{
+  return host_primask;
+}
+
+static inline void __set_PRIMASK (uint32_t primask)
+{
+  host_primask = primask;
+}
+
+static inline void __disable_irq (void)
+{
+  host_primask = 1U;
+}
+
+static inline void __enable_irq (void)
+{
+  host_primask = 0U;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32F4XX_HAL_H_ */
@@ -0,0 +1,346 @@
+/**
+  *******************************************************************************
+  *
+  * @file    host_cat.c
+  * @brief   Host stand-ins for the firmware around the CAT and WinKeyer parsers
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *
+  * cat_if.c, wk_if.c and the PTT and VFO code of ptt_if.c are built as they
+  * are. The CDC output, the CW encoder and the sequencer, event, DSP and
+  * monitor hooks they call are replaced by functions which log the calls.
+  *
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "host_cat.h"
+#include "cat_if.h"
+#include "wk_if.h"
+#include "ptt_if.h"
+#include "cw_gen.h"
+#include "dsp_if.h"
+#include "evt_if.h"
+#include "seq_if.h"
+#include "lp_if.h"
+#include "mon_if.h"
+#include "sched_if.h"
+#include "time_if.h"
+#include "usbd_cdc_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+#define HOST_CAT_TEXT_FREE     64U    /* CW_Text_Free () after HOST_CAT_Init () */
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+HOST_CAT_TypeDef host_cat;
+
+TRX_TypeDef trx;
+CW_Keyer    cw_keyer;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+extern PTT_TypeDef ptt;
+extern VFO_TypeDef vfo;
+
+/* Private functions ---------------------------------------------------------*/
+
+uint16_t CDC_Write_FS (const uint8_t *buff, uint16_t len)
+{
+  for (uint16_t i = 0U; i < len; i++)
+  {
+    if (host_cat.reply_len < (HOST_CAT_REPLY_SIZE - 1U))
+    {
+      host_cat.reply [host_cat.reply_len++] = buff [i];
+    }
+  }
+
+  host_cat.reply [host_cat.reply_len] = 0U;
+
+  return len;
+}
+
+uint32_t TIME_Get_Us (void)
+{
+  return 0U;
+}
+
+void CW_Set_Speed (void)
+{
+  host_cat.speed_sets++;
+}
+
+void CW_Set_Keyer (void)
+{
+  host_cat.keyer_sets++;
+}
+
+void CW_Set_Pitch (uint32_t freq, uint32_t sample_rate)
+{
+  cw_keyer.pitch = freq;
+
+  UNUSED (sample_rate);
+}
+
+uint16_t CW_Text_Write (const char *text, uint16_t len)
+{
+  if (len > host_cat.text_free)
+  {
+    len = host_cat.text_free;
+  }
+
+  for (uint16_t i = 0U; i < len; i++)
+  {
+    if (host_cat.text_len < (HOST_CAT_TEXT_SIZE - 1U))
+    {
+      host_cat.text [host_cat.text_len++] = text [i];
+    }
+  }
+
+  host_cat.text [host_cat.text_len] = '\0';
+  host_cat.text_free -= len;
+
+  return len;
+}
+
+uint16_t CW_Text_Free (void)
+{
+  return host_cat.text_free;
+}
+
+uint8_t CW_Text_Pending (void)
+{
+  return host_cat.text_len != 0U;
+}
+
+void CW_Text_Clear (void)
+{
+  host_cat.text_clears++;
+}
+
+void CW_Text_Backspace (void)
+{
+}
+
+void CW_Text_Pause (uint8_t pause)
+{
+  UNUSED (pause);
+}
+
+uint32_t CW_Text_Input_Ptr (void)
+{
+  return host_cat.text_len;
+}
+
+uint8_t CW_Text_Overwrite (uint32_t pos, char c)
+{
+  UNUSED (pos);
+  UNUSED (c);
+
+  return 0U;
+}
+
+void CW_Remote_Key (uint8_t key, uint32_t stamp)
+{
+  if (host_cat.keys < HOST_CAT_KEY_LOG_SIZE)
+  {
+    host_cat.key [host_cat.keys].stamp = stamp;
+    host_cat.key [host_cat.keys].key   = key;
+  }
+
+  host_cat.keys++;
+}
+
+void CW_Remote_Set_Delay (uint32_t delay)
+{
+  host_cat.remote_delay = delay;
+}
+
+void EVT_Put (uint8_t type)
+{
+  UNUSED (type);
+}
+
+void EVT_Set_Export (uint8_t is_on)
+{
+  host_cat.export = is_on;
+}
+
+void DSP_Init (void)
+{
+}
+
+void DSP_Set_TX (void)
+{
+}
+
+void DSP_Set_RX (void)
+{
+}
+
+void DSP_Set_Mode (uint8_t mode)
+{
+  UNUSED (mode);
+}
+
+void SEQ_PTT (uint8_t ptt)
+{
+  UNUSED (ptt);
+
+  host_cat.seq_ptt++;
+}
+
+uint8_t SEQ_Set_Timing (uint8_t n, uint32_t lead, uint32_t tail)
+{
+  UNUSED (n);
+  UNUSED (lead);
+  UNUSED (tail);
+
+  return 1U;
+}
+
+uint32_t SEQ_Get_Lead_Max (void)
+{
+  return 0U;
+}
+
+uint32_t SEQ_Get_Delay (void)
+{
+  return 0U;
+}
+
+uint8_t SEQ_Get_Audio_Delay (void)
+{
+  return 0U;
+}
+
+uint32_t SEQ_Format (uint8_t n, char *buff, uint32_t size)
+{
+  UNUSED (n);
+  UNUSED (buff);
+  UNUSED (size);
+
+  return 0U;
+}
+
+void SEQ_Set_Audio_Delay (uint8_t is_on)
+{
+  UNUSED (is_on);
+}
+
+void LP_Reset (void)
+{
+}
+
+uint32_t LP_Format (char *buff, uint32_t size)
+{
+  UNUSED (size);
+
+  buff [0] = '\0';
+
+  return 0U;
+}
+
+void MON_Reset (void)
+{
+}
+
+uint32_t MON_Format (char *buff, uint32_t size)
+{
+  UNUSED (size);
+
+  buff [0] = '\0';
+
+  return 0U;
+}
+
+void SCHED_Reset (void)
+{
+}
+
+uint32_t SCHED_Format (uint8_t n, char *buff, uint32_t size)
+{
+  UNUSED (n);
+  UNUSED (buff);
+  UNUSED (size);
+
+  return 0U;
+}
+
+/**
+ * @brief This function resets the stand-ins and the parsers
+ *
+ * The VFO, PTT, CAT and WinKeyer state starts from power up state,
+ * the keyer speed is 20 WPM
+ */
+
+void HOST_CAT_Init (void)
+{
+  memset (&host_cat, 0, sizeof (host_cat));
+  memset (&trx,      0, sizeof (trx));
+  memset (&ptt,      0, sizeof (ptt));
+  memset (&cw_keyer, 0, sizeof (cw_keyer));
+
+  host_cat.text_free = HOST_CAT_TEXT_FREE;
+  cw_keyer.speed     = 20U;
+
+  PTT_Init ();
+  CAT_Init ();
+  WK_Init ();
+
+  HOST_CAT_Clear ();
+}
+
+/**
+ * @brief This function passes one USB packet to CAT as CDC_Receive_FS() does
+ *
+ * The main loop runs CAT_Handler () once per packet
+ *
+ * @param Packet data
+ * @param Packet length
+ */
+
+void HOST_CAT_Write (const uint8_t *buff, uint32_t len)
+{
+  for (uint32_t i = 0U; i < len; i++)
+  {
+    CAT_Buff_Write_Byte (buff [i]);
+  }
+
+  CAT_Handler ();
+}
+
+/**
+ * @brief This function clears the logged replies and text
+ *
+ */
+
+void HOST_CAT_Clear (void)
+{
+  host_cat.reply_len = 0U;
+  host_cat.reply [0] = 0U;
+  host_cat.text_len  = 0U;
+  host_cat.text [0]  = '\0';
+}
+
+/****END OF FILE****/
@@ -0,0 +1,64 @@
+/**
+  *******************************************************************************
+  *
+  * @file    host_hal.c
+  * @brief   Host stand-ins for the HAL GPIO and the core registers
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *
+  * Shared by the DSP and keyer core build and the CAT parser build.
+  * The GPIO ports are plain variables, a test sets IDR to drive inputs.
+  *
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_hal.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+GPIO_TypeDef host_gpio [3];
+DWT_Type     host_dwt;
+uint32_t     host_primask;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+void HAL_GPIO_WritePin (GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+  if (state == GPIO_PIN_SET)
+  {
+    port->ODR |= pin;
+  }
+  else
+  {
+    port->ODR &= ~pin;
+  }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin (GPIO_TypeDef *port, uint16_t pin)
+{
+  return (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/****END OF FILE****/
@@ -0,0 +1,133 @@
+/**
+  *******************************************************************************
+  *
+  * @file    host_stub.c
+  * @brief   Host stand-ins for the firmware around the DSP and keyer core
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *
+  * The tick, PTT, event and sequencer hooks called by cw_gen.c and
+  * dsp_if.c are replaced by functions which only log the calls. Time runs
+  * only when an audio block is processed, 1 ms per block.
+  *
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "host_stub.h"
+#include "ptt_if.h"
+#include "dsp_if.h"
+#include "evt_if.h"
+#include "seq_if.h"
+#include "time_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+HOST_TypeDef host;
+
+TRX_TypeDef  trx;
+PTT_TypeDef  ptt;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* External variables --------------------------------------------------------*/
+
+extern DSP_Delay_TypeDef dsp_delay;
+
+/* Private functions ---------------------------------------------------------*/
+
+uint32_t HAL_GetTick (void)
+{
+  return host.time_us / 1000U;
+}
+
+void HAL_Delay (uint32_t delay)
+{
+  host.time_us += delay * 1000U;
+}
+
+uint32_t TIME_Get_Us (void)
+{
+  return host.time_us;
+}
+
+void PTT_Key_On (void)
+{
+  host.key_on++;
+  trx.is_tx = 1U;
+}
+
+void PTT_Key_Off_Time (void)
+{
+  host.key_off_time++;
+}
+
+void EVT_Put_Time (uint8_t type, uint32_t time)
+{
+  UNUSED (type);
+  UNUSED (time);
+
+  host.events++;
+}
+
+void SEQ_Key (uint8_t key, uint32_t time)
+{
+  if (host.edges < HOST_EDGE_LOG_SIZE)
+  {
+    host.edge [host.edges].time = time;
+    host.edge [host.edges].key  = key;
+  }
+
+  host.edges++;
+}
+
+/**
+ * @brief This function resets the host stand-ins and initializes DSP
+ *
+ * The keyer, DDS and TX delay line start from power up state, so a run
+ * does not depend on the runs before it
+ */
+
+void HOST_Init (void)
+{
+  memset (&host,      0, sizeof (host));
+  memset (&trx,       0, sizeof (trx));
+  memset (&ptt,       0, sizeof (ptt));
+  memset (&dsp_delay, 0, sizeof (dsp_delay));
+
+  DSP_Init ();
+}
+
+/**
+ * @brief This function processes one audio block as USB audio IN does
+ *
+ * @param Stereo buffer of HOST_BLOCK_SIZE values
+ */
+
+void HOST_Audio_Block (int16_t *buff)
+{
+  DSP_In_Buff_Read ((uint8_t*) buff, HOST_BLOCK_SIZE * sizeof (int16_t));
+
+  host.time_us += HOST_BLOCK_TIME;
+}
+
+/****END OF FILE****/
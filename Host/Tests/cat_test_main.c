@@ -0,0 +1,467 @@
+/**
+  *******************************************************************************
+  *
+  * @file    cat_test_main.c
+  * @brief   Host test runner for the CAT, WinKeyer and remote keying parsers
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_cat.h"
+#include "cat_if.h"
+#include "wk_if.h"
+#include "ptt_if.h"
+#include "cw_gen.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct
+{
+  const char *name;
+  void (*test) (void);
+} TEST_TypeDef;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+#define CHECK(cond)                                                         \
+  do                                                                        \
+  {                                                                         \
+    test_checks++;                                                          \
+    if (!(cond))                                                            \
+    {                                                                       \
+      printf ("  %s:%d: CHECK (%s) failed\n", __FILE__, __LINE__, #cond);   \
+      test_failed++;                                                        \
+    }                                                                       \
+  }                                                                         \
+  while (0)
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint32_t test_checks;
+static uint32_t test_failed;
+
+/* External variables --------------------------------------------------------*/
+
+extern TRX_TypeDef trx;
+extern VFO_TypeDef vfo;
+extern PTT_TypeDef ptt;
+extern CW_Keyer    cw_keyer;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function sends a string as one USB packet
+ *
+ * @param Command string
+ */
+
+static void send (const char *str)
+{
+  HOST_CAT_Write ((const uint8_t*) str, strlen (str));
+}
+
+/**
+ * @brief This function sends a string and checks the reply
+ *
+ * @param Command string
+ * @param Expected reply, "" if there must be none
+ * @retval 1 if the reply matches
+ */
+
+static uint8_t send_reply (const char *str, const char *reply)
+{
+  uint8_t match;
+
+  HOST_CAT_Clear ();
+  send (str);
+
+  match = (host_cat.reply_len == strlen (reply)) &&
+          (memcmp (host_cat.reply, reply, host_cat.reply_len) == 0);
+
+  if (!match)
+  {
+    printf ("  \"%s\" -> \"%s\", expected \"%s\"\n", str, (const char*) host_cat.reply, reply);
+  }
+
+  return match;
+}
+
+/**
+ * @brief KS is clamped to 4...60 WPM, other lengths are refused
+ *
+ */
+
+static void test_ks (void)
+{
+  HOST_CAT_Init ();
+
+  CHECK (send_reply ("KS;", "KS020;"));
+
+  CHECK (send_reply ("KS030;", ""));
+  CHECK (cw_keyer.speed == 30U);
+  CHECK (host_cat.speed_sets == 1U);
+
+  CHECK (send_reply ("KS001;", ""));
+  CHECK (cw_keyer.speed == 4U);
+
+  CHECK (send_reply ("KS099;", ""));
+  CHECK (cw_keyer.speed == 60U);
+
+  CHECK (send_reply ("ks025;", ""));
+  CHECK (send_reply ("KS;", "KS025;"));
+
+  CHECK (send_reply ("KS25;", "?;"));
+  CHECK (send_reply ("KS0250;", "?;"));
+  CHECK (send_reply ("KS02A;", "?;"));
+  CHECK (cw_keyer.speed == 25U);
+  CHECK (host_cat.speed_sets == 4U);
+}
+
+/**
+ * @brief KY trims the padding to one word space, refuses more than 24 characters
+ *
+ */
+
+static void test_ky (void)
+{
+  HOST_CAT_Init ();
+
+  CHECK (send_reply ("KY;", "KY0;"));
+
+  CHECK (send_reply ("KY CQ TEST     ;", ""));
+  CHECK (strcmp (host_cat.text, "CQ TEST ") == 0);
+
+  /* Exactly 24 characters with the padding */
+  CHECK (send_reply ("KY 123456789012345678901234;", ""));
+  CHECK (strcmp (host_cat.text, "123456789012345678901234") == 0);
+
+  CHECK (send_reply ("KY 1234567890123456789012345;", "?;"));
+  CHECK (host_cat.text_len == 0U);
+
+  CHECK (send_reply ("KYCQ;", "?;"));
+  CHECK (host_cat.text_len == 0U);
+
+  /* One space only is a word space */
+  CHECK (send_reply ("KY  ;", ""));
+  CHECK (strcmp (host_cat.text, " ") == 0);
+
+  /* The encoder buffer is nearly full */
+  host_cat.text_free = 3U;
+
+  CHECK (send_reply ("KY;", "KY1;"));
+  CHECK (send_reply ("KY TEST;", "?;"));
+}
+
+/**
+ * @brief FA and FB take 11 digits in Hz, BCD of the active VFO matches them
+ *
+ */
+
+static void test_fa_fb (void)
+{
+  HOST_CAT_Init ();
+
+  CHECK (send_reply ("FA;", "FA00014025000;"));
+  CHECK (send_reply ("FB;", "FB00014025000;"));
+
+  CHECK (send_reply ("FA00007030000;", ""));
+  CHECK (send_reply ("FB00021060050;", ""));
+  CHECK (send_reply ("FA;", "FA00007030000;"));
+  CHECK (send_reply ("FB;", "FB00021060050;"));
+
+  CHECK (send_reply ("FA7030000;", "?;"));
+  CHECK (send_reply ("FA000070300000;", "?;"));
+  CHECK (send_reply ("FA0000703000X;", "?;"));
+  CHECK (vfo.tune [0] == 7030000U);
+
+  /* 8 BCD digits in 10 Hz units */
+  CHECK (VFO_Get_Tune_BCD () == 0x00703000U);
+
+  VFO_Set_Tune_BCD (0x01402550U);
+  CHECK (send_reply ("FA;", "FA00014025500;"));
+  CHECK (VFO_Get_Tune_BCD () == 0x01402550U);
+
+  /* A digit above 9 is ignored */
+  VFO_Set_Tune_BCD (0x0140255AU);
+  CHECK (VFO_Get_Tune () == 14025500U);
+
+  /* BCD follows the active VFO */
+  CHECK (send_reply ("FR1;", ""));
+  CHECK (VFO_Get_Tune_BCD () == 0x02106005U);
+}
+
+/**
+ * @brief FR selects RX VFO and ends split, FT selects TX VFO
+ *
+ */
+
+static void test_fr_ft (void)
+{
+  HOST_CAT_Init ();
+
+  CHECK (send_reply ("FR;", "FR0;"));
+  CHECK (send_reply ("FT;", "FT0;"));
+
+  CHECK (send_reply ("FT1;", ""));
+  CHECK (vfo.split == 1U);
+  CHECK (send_reply ("FT;", "FT1;"));
+  CHECK (send_reply ("FR;", "FR0;"));
+
+  CHECK (send_reply ("FR1;", ""));
+  CHECK (vfo.active == 1U);
+  CHECK (vfo.split == 0U);
+  CHECK (send_reply ("FT;", "FT1;"));
+
+  CHECK (send_reply ("FT0;", ""));
+  CHECK (send_reply ("FT;", "FT0;"));
+  CHECK (send_reply ("FR;", "FR1;"));
+
+  CHECK (send_reply ("FR2;", "?;"));
+  CHECK (send_reply ("FT10;", "?;"));
+  CHECK (vfo.active == 1U);
+}
+
+/**
+ * @brief MD, TX and RX
+ *
+ */
+
+static void test_md_tx_rx (void)
+{
+  HOST_CAT_Init ();
+
+  CHECK (send_reply ("MD;", "MD3;"));
+  CHECK (send_reply ("MD7;", ""));
+  CHECK (send_reply ("MD;", "MD7;"));
+  CHECK (send_reply ("MD0;", "?;"));
+  CHECK (send_reply ("MD10;", "?;"));
+  CHECK (trx.mode == 7U);
+
+  CHECK (send_reply ("TX3;", "?;"));
+  CHECK (send_reply ("TX00;", "?;"));
+  CHECK (trx.is_tx == 0U);
+
+  CHECK (send_reply ("TX1;", ""));
+  CHECK (trx.is_tx == 1U);
+  CHECK (ptt.cat_is_on == 1U);
+
+  CHECK (send_reply ("RX;", ""));
+  CHECK (trx.is_tx == 0U);
+
+  CHECK (send_reply ("TX;", ""));
+  CHECK (trx.is_tx == 1U);
+
+  /* The paddle keeps TX after CAT RX */
+  ptt.key_dit_is_on = 1U;
+  CHECK (send_reply ("RX;", ""));
+  CHECK (trx.is_tx == 1U);
+  CHECK (host_cat.seq_ptt == 3U);
+}
+
+/**
+ * @brief Terminators, unknown and too long commands
+ *
+ */
+
+static void test_terminators (void)
+{
+  char cmd [CAT_CMD_SIZE + 8U];
+
+  HOST_CAT_Init ();
+
+  CHECK (send_reply ("KS\r", "KS020;"));
+  CHECK (send_reply ("ID\n", "ID" CAT_ID ";"));
+  CHECK (send_reply (";;\r\n", ""));
+  CHECK (send_reply ("ZZ;", "?;"));
+  CHECK (send_reply ("K;", "?;"));
+
+  /* A command split across packets */
+  HOST_CAT_Clear ();
+  send ("F");
+  send ("A0000703");
+  send ("0000");
+  CHECK (host_cat.reply_len == 0U);
+  send (";FA;");
+  CHECK (strcmp ((const char*) host_cat.reply, "FA00007030000;") == 0);
+
+  /* Too long command is dropped up to the terminator, the next one works */
+  memset (cmd, 'A', sizeof (cmd));
+  memcpy (cmd, "FA", 2U);
+  cmd [sizeof (cmd) - 1U] = '\0';
+
+  CHECK (send_reply (cmd, ""));
+  CHECK (send_reply (";KS;", "KS020;"));
+  CHECK (vfo.tune [0] == 7030000U);
+}
+
+/**
+ * @brief 0xA5 remote keying frames, whole and split across packets
+ *
+ */
+
+static void test_key_frames (void)
+{
+  static const uint8_t down [] = { CAT_KEY_SYNC, CAT_KEY_DOWN, 0x10U, 0x27U, 0x00U, 0x00U };
+  static const uint8_t up [] = { CAT_KEY_SYNC, CAT_KEY_UP, 0x3BU, 0x3BU, 0x01U, 0x80U };
+  static const uint8_t delay [] = { CAT_KEY_SYNC, CAT_KEY_DELAY, 0x28U, 0x00U, 0x00U, 0x00U };
+  static const uint8_t export [] = { CAT_KEY_SYNC, CAT_KEY_EXPORT, 0x01U, 0x00U, 0x00U, 0x00U };
+  static const uint8_t other [] = { CAT_KEY_SYNC, 0x7FU, 0x01U, 0x00U, 0x00U, 0x00U };
+
+  HOST_CAT_Init ();
+
+  HOST_CAT_Write (down, sizeof (down));
+  CHECK (host_cat.keys == 1U);
+  CHECK (host_cat.key [0].key == 1U);
+  CHECK (host_cat.key [0].stamp == 10000U);
+
+  /* Split after the sync byte and in the value, ';' is a value byte */
+  HOST_CAT_Write (up, 1U);
+  HOST_CAT_Write (up + 1U, 2U);
+  CHECK (host_cat.keys == 1U);
+  HOST_CAT_Write (up + 3U, 3U);
+  CHECK (host_cat.keys == 2U);
+  CHECK (host_cat.key [1].key == 0U);
+  CHECK (host_cat.key [1].stamp == 0x80013B3BU);
+  CHECK (host_cat.reply_len == 0U);
+
+  HOST_CAT_Write (delay, sizeof (delay));
+  CHECK (host_cat.remote_delay == 40U);
+
+  HOST_CAT_Write (export, sizeof (export));
+  CHECK (host_cat.export == 1U);
+
+  /* Unknown type is skipped as a whole frame */
+  HOST_CAT_Write (other, sizeof (other));
+  CHECK (host_cat.keys == 2U);
+
+  /* A frame and commands in one packet */
+  {
+    uint8_t packet [16];
+
+    memcpy (packet, "KS;", 3U);
+    memcpy (packet + 3U, down, sizeof (down));
+    memcpy (packet + 3U + sizeof (down), "MD;", 3U);
+
+    HOST_CAT_Clear ();
+    HOST_CAT_Write (packet, 3U + sizeof (down) + 3U);
+    CHECK (strcmp ((const char*) host_cat.reply, "KS020;MD3;") == 0);
+    CHECK (host_cat.keys == 3U);
+  }
+}
+
+/**
+ * @brief WinKeyer host mode owns the data until it is closed
+ *
+ */
+
+static void test_wk_switch (void)
+{
+  static const uint8_t open [] = { WK_ADMIN, WK_ADMIN_OPEN };
+  static const uint8_t close [] = { WK_ADMIN, WK_ADMIN_CLOSE };
+  static const uint8_t echo [] = { WK_ADMIN, WK_ADMIN_ECHO, 0x55U };
+  static const uint8_t speed [] = { WK_SPEED, 35U };
+  static const uint8_t frame [] = { CAT_KEY_SYNC, CAT_KEY_DOWN, 0x00U, 0x00U, 0x00U, 0x00U };
+
+  HOST_CAT_Init ();
+
+  /* Admin commands work without host mode, split across packets */
+  HOST_CAT_Write (echo, 2U);
+  CHECK (host_cat.reply_len == 0U);
+  HOST_CAT_Write (echo + 2U, 1U);
+  CHECK ((host_cat.reply_len == 1U) && (host_cat.reply [0] == 0x55U));
+  CHECK (!WK_Is_Active ());
+
+  CHECK (send_reply ("KS;", "KS020;"));
+
+  HOST_CAT_Clear ();
+  HOST_CAT_Write (open, 1U);
+  CHECK (WK_Is_Active ());
+  HOST_CAT_Write (open + 1U, 1U);
+  CHECK ((host_cat.reply_len == 1U) && (host_cat.reply [0] == WK_VERSION));
+  CHECK (WK_Is_Active ());
+
+  /* CAT commands are text to send in host mode */
+  HOST_CAT_Clear ();
+  send ("KS;");
+  CHECK (host_cat.reply_len == 0U);
+  CHECK (strcmp (host_cat.text, "KS;") == 0);
+
+  HOST_CAT_Write (speed, sizeof (speed));
+  CHECK (cw_keyer.speed == 35U);
+
+  /* The sync byte is text too */
+  HOST_CAT_Clear ();
+  HOST_CAT_Write (frame, 1U);
+  CHECK (host_cat.keys == 0U);
+  CHECK ((host_cat.text_len == 1U) && ((uint8_t) host_cat.text [0] == CAT_KEY_SYNC));
+
+  HOST_CAT_Clear ();
+  HOST_CAT_Write (close, sizeof (close));
+  CHECK (!WK_Is_Active ());
+  CHECK (host_cat.reply_len == 0U);
+
+  /* Back to CAT and remote keying */
+  CHECK (send_reply ("KS;", "KS035;"));
+
+  HOST_CAT_Write (frame, sizeof (frame));
+  CHECK (host_cat.keys == 1U);
+}
+
+static const TEST_TypeDef tests [] =
+{
+  { "ks",           test_ks           },
+  { "ky",           test_ky           },
+  { "fa_fb",        test_fa_fb        },
+  { "fr_ft",        test_fr_ft        },
+  { "md_tx_rx",     test_md_tx_rx     },
+  { "terminators",  test_terminators  },
+  { "key_frames",   test_key_frames   },
+  { "wk_switch",    test_wk_switch    },
+};
+
+/**
+ * @brief The application entry point
+ *
+ */
+
+int main (void)
+{
+  uint32_t failed_tests = 0U;
+
+  for (uint32_t n = 0U; n < sizeof (tests) / sizeof (tests [0]); n++)
+  {
+    uint32_t failed = test_failed;
+
+    tests [n].test ();
+
+    printf ("%-16s %s\n", tests [n].name, (test_failed == failed) ? "ok" : "FAILED");
+
+    if (test_failed != failed)
+    {
+      failed_tests++;
+    }
+  }
+
+  printf ("%u checks, %u failed\n", (unsigned int) test_checks, (unsigned int) test_failed);
+
+  return failed_tests ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/****END OF FILE****/
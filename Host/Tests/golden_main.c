@@ -0,0 +1,622 @@
+/**
+  *******************************************************************************
+  *
+  * @file    golden_main.c
+  * @brief   Golden waveform regression suite for the keyer
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *
+  * Paddle and DTR timelines from Tests/traces/ *.trc are replayed through
+  * the record path packet by packet. TX signal is routed as I/Q, so its
+  * envelope is exact. The elements found in it (sample positions where
+  * the envelope crosses GOLD_ON_LEVEL) and the envelope shape of the
+  * first element are compared with Tests/golden/ *.gold. Random traces are checked by element statistics.
+  *
+  * Usage: selenite_golden <Tests dir> [--update]
+  *
+  * Trace file:
+  *   mode IAMBIC_A | IAMBIC_B | ULTIMATE | STRAIGHT
+  *   speed <WPM>
+  *   <time ms> DIT | DAH | DTR <0 | 1>
+  *   random <seed>            paddles are pressed at random
+  *   end <time ms>
+  *
+  * Traces share the keyer and run in name order, as golden files were made.
+  *
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <math.h>
+
+#include "host_stub.h"
+#include "cw_gen.h"
+#include "ptt_if.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define GOLD_EVENTS_MAX     1024U
+#define GOLD_ELEMENTS_MAX   1024U   /* Elements compared one by one */
+#define GOLD_ENV_POINTS     32U     /* Envelope points at every GOLD_ENV_STEP samples */
+#define GOLD_ENV_STEP       8U
+#define GOLD_ENV_LEN        (GOLD_ENV_POINTS * GOLD_ENV_STEP)
+#define GOLD_ENV_RING       (GOLD_ENV_LEN * 2U)   /* Keeps the fall while the element end is held */
+
+#define GOLD_ON_LEVEL       8       /* Envelope of an element, LSB, lower values are rounding */
+#define GOLD_HOLD           48U     /* Low envelope time to end an element, samples */
+#define GOLD_EDGE_TOL       2U      /* Edge position tolerance, samples */
+#define GOLD_ENV_TOL        64      /* Envelope tolerance, LSB */
+#define GOLD_STAT_TOL       48U     /* Element length statistics tolerance, samples */
+
+#define GOLD_DIT            0U
+#define GOLD_DAH            1U
+#define GOLD_DTR            2U
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct
+{
+  uint32_t time;        /* ms */
+  uint8_t  line;        /* GOLD_DIT, GOLD_DAH, GOLD_DTR */
+  uint8_t  state;
+} GOLD_Event_TypeDef;
+
+typedef struct
+{
+  uint8_t  mode;
+  uint8_t  speed;
+  uint8_t  random;
+  uint32_t seed;
+  uint32_t end;         /* ms */
+  GOLD_Event_TypeDef event [GOLD_EVENTS_MAX];
+  uint32_t events;
+} GOLD_Trace_TypeDef;
+
+typedef struct
+{
+  uint32_t start;       /* Sample where the envelope rises over GOLD_ON_LEVEL */
+  uint32_t stop;        /* Sample where it falls back */
+} GOLD_Element_TypeDef;
+
+typedef struct
+{
+  GOLD_Element_TypeDef element [GOLD_ELEMENTS_MAX];
+  uint32_t elements;
+  int32_t  rise [GOLD_ENV_POINTS];  /* Envelope of the first element */
+  int32_t  fall [GOLD_ENV_POINTS];
+  uint32_t dits;
+  uint32_t dahs;
+  uint32_t dit_min, dit_max;
+  uint32_t dah_min, dah_max;
+  uint32_t key_down;    /* ms */
+} GOLD_Result_TypeDef;
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+static GOLD_Trace_TypeDef  trace;
+static GOLD_Result_TypeDef result;
+static GOLD_Result_TypeDef golden;
+
+static int16_t block [HOST_BLOCK_SIZE];
+
+/* Envelope history of the current element */
+static int32_t env_ring [GOLD_ENV_RING];
+
+/* External variables --------------------------------------------------------*/
+
+extern CW_Keyer cw_keyer;
+extern PTT_TypeDef ptt;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function reads a trace file
+ *
+ * @retval 0 - ok, 1 - error
+ */
+
+static uint8_t gold_read_trace (const char *path)
+{
+  FILE *f = fopen (path, "r");
+  char  line [128], word [16];
+  unsigned int time, state;
+
+  if (f == NULL) return 1U;
+
+  memset (&trace, 0, sizeof (trace));
+  trace.mode  = IAMBIC_B;
+  trace.speed = 20U;
+
+  while (fgets (line, sizeof (line), f) != NULL)
+  {
+    if ((line [0] == '#') || (line [0] == '\n')) continue;
+
+    if (sscanf (line, "mode %15s", word) == 1)
+    {
+      if      (!strcmp (word, "IAMBIC_A")) trace.mode = IAMBIC_A;
+      else if (!strcmp (word, "IAMBIC_B")) trace.mode = IAMBIC_B;
+      else if (!strcmp (word, "ULTIMATE")) trace.mode = ULTIMATE;
+      else if (!strcmp (word, "STRAIGHT")) trace.mode = STRAIGHT;
+    }
+    else if (sscanf (line, "speed %u", &time) == 1)
+    {
+      trace.speed = time;
+    }
+    else if (sscanf (line, "random %u", &time) == 1)
+    {
+      trace.random = 1U;
+      trace.seed   = time;
+    }
+    else if (sscanf (line, "end %u", &time) == 1)
+    {
+      trace.end = time;
+    }
+    else if ((sscanf (line, "%u %15s %u", &time, word, &state) == 3) && (trace.events < GOLD_EVENTS_MAX))
+    {
+      trace.event [trace.events].time  = time;
+      trace.event [trace.events].line  = !strcmp (word, "DIT") ? GOLD_DIT : !strcmp (word, "DAH") ? GOLD_DAH : GOLD_DTR;
+      trace.event [trace.events].state = state;
+      trace.events++;
+    }
+  }
+
+  fclose (f);
+
+  return 0U;
+}
+
+/**
+ * @brief This function returns the next pseudo random number
+ *
+ */
+
+static uint32_t gold_random (void)
+{
+  trace.seed ^= trace.seed << 13;
+  trace.seed ^= trace.seed >> 17;
+  trace.seed ^= trace.seed << 5;
+
+  return trace.seed;
+}
+
+/**
+ * @brief This function sets paddles and DTR for the current time
+ *
+ * @param Time in ms
+ * @param Index of the next trace event
+ * @param Time of the next random change, ms
+ */
+
+static void gold_set_lines (uint32_t ms, uint32_t *next, uint32_t *change)
+{
+  if (trace.random)
+  {
+    if (ms >= *change)
+    {
+      /* Paddles are pressed for 20...400 ms and released for 20...600 ms */
+      if (ptt.key_dit_is_on || ptt.key_dah_is_on)
+      {
+        ptt.key_dit_is_on = 0U;
+        ptt.key_dah_is_on = 0U;
+        *change = ms + 20U + gold_random () % 580U;
+      }
+      else
+      {
+        uint32_t r = gold_random ();
+
+        ptt.key_dit_is_on = (r & 3U) != 1U;
+        ptt.key_dah_is_on = (r & 3U) != 0U;
+        *change = ms + 20U + (r >> 8) % 380U;
+      }
+    }
+    return;
+  }
+
+  while ((*next < trace.events) && (trace.event [*next].time <= ms))
+  {
+    GOLD_Event_TypeDef *e = &trace.event [*next];
+
+    switch (e->line)
+    {
+      case GOLD_DIT:
+        ptt.key_dit_is_on = e->state;
+        break;
+      case GOLD_DAH:
+        ptt.key_dah_is_on = e->state;
+        break;
+      default:
+        ptt.dtr_is_on = e->state;
+        break;
+    }
+
+    (*next)++;
+  }
+}
+
+/**
+ * @brief This function adds a finished element to the result
+ *
+ */
+
+static void gold_put_element (uint32_t start, uint32_t stop)
+{
+  uint32_t len = stop - start;
+  uint32_t dit = (1200U / trace.speed + 6U) * HOST_BLOCK_SAMPLES;
+
+  if (result.elements < GOLD_ELEMENTS_MAX)
+  {
+    result.element [result.elements].start = start;
+    result.element [result.elements].stop  = stop;
+  }
+
+  if (result.elements == 0U)
+  {
+    for (uint32_t k = 0U; k < GOLD_ENV_POINTS; k++)
+    {
+      result.fall [k] = env_ring [(stop - 1U - k * GOLD_ENV_STEP) % GOLD_ENV_RING];
+    }
+  }
+
+  result.elements++;
+  result.key_down += len;
+
+  /* Straight key elements are counted as dits or dahs by length too */
+  if (len < 2U * dit)
+  {
+    if (result.dits == 0U || len < result.dit_min) result.dit_min = len;
+    if (len > result.dit_max) result.dit_max = len;
+    result.dits++;
+  }
+  else
+  {
+    if (result.dahs == 0U || len < result.dah_min) result.dah_min = len;
+    if (len > result.dah_max) result.dah_max = len;
+    result.dahs++;
+  }
+}
+
+/**
+ * @brief This function replays the trace and finds the elements
+ *
+ */
+
+static void gold_run (void)
+{
+  uint32_t next = 0U, change = 0U;
+  uint32_t sample = 0U, start = 0U, stop = 0U, hold = 0U;
+  uint8_t  in_element = 0U;
+
+  memset (&result, 0, sizeof (result));
+
+  /* Every trace starts from power up state, not from where the last one ended */
+  HOST_Init ();
+
+  cw_keyer.mode  = trace.mode;
+  cw_keyer.speed = trace.speed;
+  CW_Set_Keyer ();
+  CW_Set_Route (CW_ROUTE_TX_I, CW_ROUTE_TX_Q);
+
+  for (uint32_t ms = 0U; ms < trace.end; ms++)
+  {
+    gold_set_lines (ms, &next, &change);
+
+    HOST_Audio_Block (block);
+
+    for (uint32_t i = 0U; i < HOST_BLOCK_SIZE; i += 2U, sample++)
+    {
+      int32_t pwr = block [i] * block [i] + block [i + 1] * block [i + 1];
+      uint8_t on  = pwr > GOLD_ON_LEVEL * GOLD_ON_LEVEL;
+
+      if (on || in_element)
+      {
+        int32_t env = (int32_t) lround (hypot (block [i], block [i + 1]));
+
+        if (on && !in_element)
+        {
+          in_element = 1U;
+          start      = sample;
+        }
+
+        /* Element is over when the envelope stays low for GOLD_HOLD samples */
+        if (in_element && !on)
+        {
+          if (hold++ == 0U)
+          {
+            stop = sample;
+          }
+
+          if (hold >= GOLD_HOLD)
+          {
+            in_element = 0U;
+            hold       = 0U;
+            gold_put_element (start, stop);
+            continue;
+          }
+        }
+        else
+        {
+          hold = 0U;
+        }
+
+        env_ring [sample % GOLD_ENV_RING] = env;
+
+        if ((result.elements == 0U) && (sample - start < GOLD_ENV_LEN) && !((sample - start) % GOLD_ENV_STEP))
+        {
+          result.rise [(sample - start) / GOLD_ENV_STEP] = env;
+        }
+      }
+    }
+  }
+
+  ptt.key_dit_is_on = 0U;
+  ptt.key_dah_is_on = 0U;
+  ptt.dtr_is_on     = 0U;
+}
+
+/**
+ * @brief This function writes the result as a golden file
+ *
+ */
+
+static uint8_t gold_write (const char *path)
+{
+  FILE *f = fopen (path, "w");
+
+  if (f == NULL) return 1U;
+
+  fprintf (f, "# Made by selenite_golden --update\n");
+  fprintf (f, "elements %u\n", result.elements);
+
+  if (!trace.random)
+  {
+    for (uint32_t n = 0U; (n < result.elements) && (n < GOLD_ELEMENTS_MAX); n++)
+    {
+      fprintf (f, "element %u %u\n", result.element [n].start, result.element [n].stop);
+    }
+
+    fprintf (f, "rise");
+    for (uint32_t k = 0U; k < GOLD_ENV_POINTS; k++) fprintf (f, " %d", result.rise [k]);
+    fprintf (f, "\nfall");
+    for (uint32_t k = 0U; k < GOLD_ENV_POINTS; k++) fprintf (f, " %d", result.fall [k]);
+    fprintf (f, "\n");
+  }
+
+  fprintf (f, "dits %u %u %u\n", result.dits, result.dit_min, result.dit_max);
+  fprintf (f, "dahs %u %u %u\n", result.dahs, result.dah_min, result.dah_max);
+  fprintf (f, "key_down %u\n", result.key_down);
+
+  fclose (f);
+
+  return 0U;
+}
+
+/**
+ * @brief This function reads a golden file
+ *
+ */
+
+static uint8_t gold_read (const char *path)
+{
+  FILE *f = fopen (path, "r");
+  char  line [512];
+  unsigned int a, b, c;
+  uint32_t n = 0U;
+
+  if (f == NULL) return 1U;
+
+  memset (&golden, 0, sizeof (golden));
+
+  while (fgets (line, sizeof (line), f) != NULL)
+  {
+    if (sscanf (line, "elements %u", &a) == 1)
+    {
+      golden.elements = a;
+    }
+    else if ((sscanf (line, "element %u %u", &a, &b) == 2) && (n < GOLD_ELEMENTS_MAX))
+    {
+      golden.element [n].start = a;
+      golden.element [n].stop  = b;
+      n++;
+    }
+    else if (!strncmp (line, "rise", 4) || !strncmp (line, "fall", 4))
+    {
+      int32_t *env = (line [0] == 'r') ? golden.rise : golden.fall;
+      char    *p   = line + 4;
+
+      for (uint32_t k = 0U; k < GOLD_ENV_POINTS; k++)
+      {
+        env [k] = strtol (p, &p, 10);
+      }
+    }
+    else if (sscanf (line, "dits %u %u %u", &a, &b, &c) == 3)
+    {
+      golden.dits = a; golden.dit_min = b; golden.dit_max = c;
+    }
+    else if (sscanf (line, "dahs %u %u %u", &a, &b, &c) == 3)
+    {
+      golden.dahs = a; golden.dah_min = b; golden.dah_max = c;
+    }
+    else if (sscanf (line, "key_down %u", &a) == 1)
+    {
+      golden.key_down = a;
+    }
+  }
+
+  fclose (f);
+
+  return 0U;
+}
+
+/**
+ * @brief This function returns 1 if the values differ more than tolerance
+ *
+ */
+
+static uint8_t gold_differ (int64_t a, int64_t b, int64_t tol)
+{
+  return (a > b + tol) || (b > a + tol);
+}
+
+/**
+ * @brief This function compares the result with the golden one
+ *
+ * @retval Number of differences
+ */
+
+static uint32_t gold_compare (void)
+{
+  uint32_t diff = 0U;
+
+  if (result.elements != golden.elements)
+  {
+    printf ("  elements %u, golden %u\n", result.elements, golden.elements);
+    diff++;
+  }
+
+  if (!trace.random)
+  {
+    for (uint32_t n = 0U; (n < result.elements) && (n < golden.elements) && (n < GOLD_ELEMENTS_MAX); n++)
+    {
+      if (gold_differ (result.element [n].start, golden.element [n].start, GOLD_EDGE_TOL) ||
+          gold_differ (result.element [n].stop,  golden.element [n].stop,  GOLD_EDGE_TOL))
+      {
+        printf ("  element %u at %u...%u, golden %u...%u\n", n,
+                result.element [n].start, result.element [n].stop,
+                golden.element [n].start, golden.element [n].stop);
+        diff++;
+      }
+    }
+
+    for (uint32_t k = 0U; k < GOLD_ENV_POINTS; k++)
+    {
+      if (gold_differ (result.rise [k], golden.rise [k], GOLD_ENV_TOL) ||
+          gold_differ (result.fall [k], golden.fall [k], GOLD_ENV_TOL))
+      {
+        printf ("  envelope point %u: rise %d fall %d, golden %d %d\n", k,
+                result.rise [k], result.fall [k], golden.rise [k], golden.fall [k]);
+        diff++;
+      }
+    }
+  }
+
+  if ((result.dits != golden.dits) || (result.dahs != golden.dahs) ||
+      gold_differ (result.dit_min, golden.dit_min, GOLD_STAT_TOL) ||
+      gold_differ (result.dit_max, golden.dit_max, GOLD_STAT_TOL) ||
+      gold_differ (result.dah_min, golden.dah_min, GOLD_STAT_TOL) ||
+      gold_differ (result.dah_max, golden.dah_max, GOLD_STAT_TOL) ||
+      gold_differ (result.key_down, golden.key_down, (int64_t) GOLD_EDGE_TOL * result.elements))
+  {
+    printf ("  dits %u %u...%u, dahs %u %u...%u, key down %u\n",
+            result.dits, result.dit_min, result.dit_max,
+            result.dahs, result.dah_min, result.dah_max, result.key_down);
+    printf ("  golden dits %u %u...%u, dahs %u %u...%u, key down %u\n",
+            golden.dits, golden.dit_min, golden.dit_max,
+            golden.dahs, golden.dah_min, golden.dah_max, golden.key_down);
+    diff++;
+  }
+
+  return diff;
+}
+
+/**
+ * @brief This function selects trace files
+ *
+ */
+
+static int gold_is_trace (const struct dirent *d)
+{
+  size_t len = strlen (d->d_name);
+
+  return (len > 4U) && !strcmp (d->d_name + len - 4U, ".trc");
+}
+
+/**
+ * @brief The application entry point
+ *
+ */
+
+int main (int argc, char *argv [])
+{
+  struct dirent **names;
+  char path [512];
+  uint8_t update;
+  int n, count;
+  uint32_t failed = 0U;
+
+  if (argc < 2)
+  {
+    printf ("Usage: %s <Tests dir> [--update]\n", argv [0]);
+    return EXIT_FAILURE;
+  }
+
+  update = (argc > 2) && !strcmp (argv [2], "--update");
+
+  snprintf (path, sizeof (path), "%s/traces", argv [1]);
+  count = scandir (path, &names, gold_is_trace, alphasort);
+
+  if (count <= 0)
+  {
+    printf ("No traces in %s\n", path);
+    return EXIT_FAILURE;
+  }
+
+  for (n = 0; n < count; n++)
+  {
+    char name [256];
+
+    snprintf (name, sizeof (name), "%.*s", (int) strlen (names [n]->d_name) - 4, names [n]->d_name);
+    free (names [n]);
+
+    snprintf (path, sizeof (path), "%s/traces/%s.trc", argv [1], name);
+
+    if (gold_read_trace (path))
+    {
+      printf ("%-24s cannot read trace\n", name);
+      failed++;
+      continue;
+    }
+
+    gold_run ();
+
+    snprintf (path, sizeof (path), "%s/golden/%s.gold", argv [1], name);
+
+    if (update)
+    {
+      failed += gold_write (path);
+      printf ("%-24s %u elements written\n", name, result.elements);
+    }
+    else if (gold_read (path))
+    {
+      printf ("%-24s no golden file\n", name);
+      failed++;
+    }
+    else
+    {
+      uint32_t diff = gold_compare ();
+
+      printf ("%-24s %u elements %s\n", name, result.elements, diff ? "FAILED" : "ok");
+      failed += diff ? 1U : 0U;
+    }
+  }
+
+  free (names);
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/****END OF FILE****/
@@ -0,0 +1,358 @@
+/**
+  *******************************************************************************
+  *
+  * @file    test_main.c
+  * @brief   Host test runner for the DSP and keyer core
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "host_stub.h"
+#include "cw_gen.h"
+#include "dds_if.h"
+#include "dsp_if.h"
+#include "ptt_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct
+{
+  const char *name;
+  void (*test) (void);
+} TEST_TypeDef;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+#define CHECK(cond)                                                         \
+  do                                                                        \
+  {                                                                         \
+    test_checks++;                                                          \
+    if (!(cond))                                                            \
+    {                                                                       \
+      printf ("  %s:%d: CHECK (%s) failed\n", __FILE__, __LINE__, #cond);   \
+      test_failed++;                                                        \
+    }                                                                       \
+  }                                                                         \
+  while (0)
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint32_t test_checks;
+static uint32_t test_failed;
+
+static int16_t block [HOST_BLOCK_SIZE];
+
+/* External variables --------------------------------------------------------*/
+
+extern CW_Keyer cw_keyer;
+extern PTT_TypeDef ptt;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function runs audio blocks and returns the peak of a channel
+ *
+ * @param Number of blocks
+ * @param Channel, 0 - left, 1 - right
+ */
+
+static int32_t run_blocks (uint32_t n, uint8_t ch)
+{
+  int32_t peak = 0;
+
+  for (uint32_t k = 0U; k < n; k++)
+  {
+    HOST_Audio_Block (block);
+
+    for (uint32_t i = ch; i < HOST_BLOCK_SIZE; i += 2U)
+    {
+      if (abs (block [i]) > peak)
+      {
+        peak = abs (block [i]);
+      }
+    }
+  }
+
+  return peak;
+}
+
+/**
+ * @brief Quarter-wave DDS gives sine within a few LSB
+ *
+ */
+
+static void test_dds_sin (void)
+{
+  int32_t err = 0;
+
+  CHECK (softdds_sin (0x00000000U) == 0);
+  CHECK (softdds_sin (0x40000000U) == 32767);
+  CHECK (softdds_sin (0x80000000U) == 0);
+  CHECK (softdds_sin (0xC0000000U) == -32767);
+
+  for (uint32_t k = 0U; k < 100000U; k++)
+  {
+    uint32_t phase = k * 42949U + (k >> 3);
+    int32_t  ref   = (int32_t) lround (32767.0 * sin (2.0 * M_PI * (double) phase / 4294967296.0));
+    int32_t  d     = abs (softdds_sin (phase) - ref);
+
+    if (d > err)
+    {
+      err = d;
+    }
+  }
+
+  CHECK (err <= 2);
+}
+
+/**
+ * @brief DDS step by reciprocal is the same as by 64-bit division, at any rate
+ *
+ */
+
+static void test_dds_step (void)
+{
+  static const uint32_t rates [] = { 48000U, 32768U, 22050U, 8000U, 100U };
+
+  for (uint32_t r = 0U; r < sizeof (rates) / sizeof (rates [0]); r++)
+  {
+    for (uint32_t freq = 1U; freq <= 24000U; freq++)
+    {
+      uint32_t ref  = (uint32_t) (((uint64_t) freq << 32) / rates [r]);
+      uint32_t step = softdds_getStep (freq, rates [r]);
+
+      if (abs ((int32_t) (step - ref)) > 1)
+      {
+        CHECK (step == ref);
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Straight key makes TX signal on the right channel only while key is down
+ *
+ */
+
+static void test_straight_key (void)
+{
+  HOST_Init ();
+
+  cw_keyer.mode = STRAIGHT;
+  CW_Set_Keyer ();
+
+  CHECK (run_blocks (10U, 1U) == 0);
+
+  ptt.key_dit_is_on = 1U;
+  CHECK (run_blocks (20U, 1U) > 10000);
+  CHECK (host.edges == 1U);
+  CHECK (host.edge [0].key == 1U);
+
+  ptt.key_dit_is_on = 0U;
+  run_blocks (10U, 1U);
+  CHECK (host.edges == 2U);
+  CHECK (host.edge [1].key == 0U);
+  CHECK (run_blocks (10U, 1U) == 0);
+}
+
+/**
+ * @brief Text "E" is sent as one dit of the keyer speed
+ *
+ */
+
+static void test_text_dit (void)
+{
+  uint32_t dit;
+
+  HOST_Init ();
+
+  CW_Text_Write ("E", 1U);
+  run_blocks (600U, 1U);
+
+  CHECK (host.edges == 2U);
+  CHECK (host.edge [0].key == 1U);
+  CHECK (host.edge [1].key == 0U);
+  CHECK (host.key_on >= 1U);
+
+  /* 1200 / WPM ms plus the edge smoothing */
+  dit = (host.edge [1].time - host.edge [0].time) / 1000U;
+  CHECK (dit == 1200U / cw_keyer.speed + 6U);
+
+  CHECK (!CW_Text_Pending ());
+}
+
+/**
+ * @brief Text written after a clear is sent, as WinKeyer and KY loggers do
+ *
+ */
+
+static void test_text_clear (void)
+{
+  HOST_Init ();
+
+  CW_Text_Clear ();
+  run_blocks (50U, 1U);
+
+  CW_Text_Write ("EEE", 3U);
+  run_blocks (1500U, 1U);
+
+  CHECK (host.edges == 6U);
+  CHECK (!CW_Text_Pending ());
+
+  /* The text left is dropped, the element being keyed is completed */
+  CW_Text_Write ("TTT", 3U);
+  run_blocks (20U, 1U);
+  CW_Text_Clear ();
+  CW_Text_Write ("E", 1U);
+  run_blocks (1500U, 1U);
+
+  CHECK (host.edges == 10U);
+  CHECK (host.edge [9].key == 0U);
+  CHECK (!CW_Text_Pending ());
+}
+
+/**
+ * @brief RX audio goes to sidetone channel, not to TX channel
+ *
+ */
+
+static void test_rx_route (void)
+{
+  int16_t rx [HOST_BLOCK_SIZE];
+
+  HOST_Init ();
+
+  for (uint32_t i = 0U; i < HOST_BLOCK_SIZE; i++)
+  {
+    rx [i] = 1000;
+  }
+
+  for (uint32_t k = 0U; k < DSP_BUFF_PACKET_NUM; k++)
+  {
+    DSP_Out_Buff_Write ((uint8_t*) rx, sizeof (rx));
+  }
+
+  CHECK (run_blocks (4U, 0U) == 1000);
+  CHECK (run_blocks (4U, 1U) == 0);
+}
+
+/**
+ * @brief With TX signal delayed, RX audio is muted until the delayed signal is over
+ *
+ */
+
+static void test_qsk_delay (void)
+{
+  int16_t  rx [HOST_BLOCK_SIZE];
+  int32_t  rx_peak, tx_peak;
+  uint32_t tx_after = 0U;
+
+  HOST_Init ();
+
+  cw_keyer.mode = STRAIGHT;
+  CW_Set_Keyer ();
+  CW_Set_Sidetone (0, CW_ST_RISE);
+  DSP_Set_Delay (10U * CW_SAMPLES_PER_MS);
+
+  for (uint32_t i = 0U; i < HOST_BLOCK_SIZE; i++)
+  {
+    rx [i] = 1000;
+  }
+
+  for (uint32_t k = 0U; k < DSP_BUFF_PACKET_NUM; k++)
+  {
+    DSP_Out_Buff_Write ((uint8_t*) rx, sizeof (rx));
+  }
+
+  CHECK (run_blocks (10U, 0U) == 1000);
+
+  ptt.key_dit_is_on = 1U;
+  run_blocks (20U, 0U);
+  ptt.key_dit_is_on = 0U;
+
+  /* Sidetone is over 5 ms after key up, the delayed TX signal 10 ms later */
+  for (uint32_t k = 0U; k < 30U; k++)
+  {
+    HOST_Audio_Block (block);
+
+    rx_peak = 0;
+    tx_peak = 0;
+
+    for (uint32_t i = 0U; i < HOST_BLOCK_SIZE; i += 2U)
+    {
+      if (abs (block [i + 0]) > rx_peak) rx_peak = abs (block [i + 0]);
+      if (abs (block [i + 1]) > tx_peak) tx_peak = abs (block [i + 1]);
+    }
+
+    /* TX signal is fully on, it falls with RX audio rising after it */
+    if (tx_peak > 16000)
+    {
+      tx_after++;
+      CHECK (rx_peak == 0);
+    }
+  }
+
+  CHECK (tx_after >= 9U);
+  CHECK (run_blocks (4U, 0U) == 1000);
+  CHECK (run_blocks (4U, 1U) == 0);
+}
+
+static const TEST_TypeDef tests [] =
+{
+  { "dds_sin",      test_dds_sin      },
+  { "dds_step",     test_dds_step     },
+  { "straight_key", test_straight_key },
+  { "text_dit",     test_text_dit     },
+  { "text_clear",   test_text_clear   },
+  { "rx_route",     test_rx_route     },
+  { "qsk_delay",    test_qsk_delay    },
+};
+
+/**
+ * @brief The application entry point
+ *
+ */
+
+int main (void)
+{
+  uint32_t failed_tests = 0U;
+
+  for (uint32_t n = 0U; n < sizeof (tests) / sizeof (tests [0]); n++)
+  {
+    uint32_t failed = test_failed;
+
+    tests [n].test ();
+
+    printf ("%-16s %s\n", tests [n].name, (test_failed == failed) ? "ok" : "FAILED");
+
+    if (test_failed != failed)
+    {
+      failed_tests++;
+    }
+  }
+
+  printf ("%u checks, %u failed\n", (unsigned int) test_checks, (unsigned int) test_failed);
+
+  return failed_tests ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/****END OF FILE****/
@@ -0,0 +1,63 @@
+#!/bin/sh
+#
+# Post-build report of the audio hot path placed in RAM, see __HOT_FUNC
+#
+# Usage: hot_report.sh firmware.elf [zp_hot_ram_0.txt zp_hot_ram_1.txt]
+#
+# Prints the .hot section size and addresses, the symbols between _shot and
+# _ehot, and the long call veneers GNU ld inserted between flash and RAM.
+# With two ZP dumps (the CAT "ZP;" replies of a HOT_RAM=0 and a HOT_RAM=1
+# build captured under the same load) it also compares the MIX and CW
+# profiler zones: "ZPn,name,count,min,max,mean,hist...;" in CPU cycles.
+#
+
+PREFIX=${CROSS_COMPILE-arm-none-eabi-}
+ELF=$1
+
+if [ -z "$ELF" ] || [ ! -f "$ELF" ]; then
+  echo "usage: $0 firmware.elf [zp_hot_ram_0.txt zp_hot_ram_1.txt]" >&2
+  exit 1
+fi
+
+echo "== .hot section"
+${PREFIX}size -A -x "$ELF" | awk '$1 == ".hot" || $1 == "section" { print }'
+
+${PREFIX}nm -n "$ELF" > "$ELF.nm" || exit 1
+
+SHOT=$(awk '$3 == "_shot"  { print $1 }' "$ELF.nm")
+EHOT=$(awk '$3 == "_ehot"  { print $1 }' "$ELF.nm")
+SIHOT=$(awk '$3 == "_sihot" { print $1 }' "$ELF.nm")
+
+if [ -z "$SHOT" ] || [ -z "$EHOT" ]; then
+  echo "no _shot/_ehot symbols, not linked with STM32F411CEUX_FLASH.ld?"
+  rm -f "$ELF.nm"
+  exit 0
+fi
+
+echo "RAM 0x$SHOT..0x$EHOT, load address 0x$SIHOT"
+
+echo "== symbols in .hot"
+${PREFIX}nm -n -S "$ELF" | awk -v s="$SHOT" -v e="$EHOT" '
+  function hex(x,  i, c, v) { v = 0; x = tolower(x);
+    for (i = 1; i <= length(x); i++) { c = index("0123456789abcdef", substr(x, i, 1)); v = v * 16 + c - 1 }
+    return v }
+  NF == 4 && hex($1) >= hex(s) && hex($1) < hex(e) { printf "%s %6d %s %s\n", $1, hex($2), $3, $4 }'
+
+echo "== veneers (flash <-> RAM calls)"
+awk '$3 ~ /_veneer$/ { print $1, $3 }' "$ELF.nm"
+
+rm -f "$ELF.nm"
+
+[ $# -lt 3 ] && exit 0
+
+echo "== profiler zones, cycles: HOT_RAM=0 / HOT_RAM=1"
+awk -F '[,;]' '
+  FNR == 1 { build++ }
+  $2 == "MIX" || $2 == "CW" { min[$2, build] = $4; max[$2, build] = $5; mean[$2, build] = $6 }
+  END {
+    printf "%-4s %13s %13s %13s\n", "zone", "min", "max", "mean"
+    split("MIX CW", z, " ")
+    for (i = 1; i <= 2; i++)
+      printf "%-4s %6d/%-6d %6d/%-6d %6d/%-6d\n", z[i],
+             min[z[i], 1], min[z[i], 2], max[z[i], 1], max[z[i], 2], mean[z[i], 1], mean[z[i], 2]
+  }' "$2" "$3"
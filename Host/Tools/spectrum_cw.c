@@ -0,0 +1,597 @@
+/**
+  *******************************************************************************
+  *
+  * @file    spectrum_cw.c
+  * @brief   Spectral purity and key click analysis of the generated CW
+  * @version v1.0
+  * @date    19.10.2026
+  * @author  Dmitrii Rudnev
+  *
+  *******************************************************************************
+  * Copyrigh &copy; 2026 Selenite Project. All rights reserved.
+  *
+  * This software component is licensed under [BSD 3-Clause license]
+  * (http://opensource.org/licenses/BSD-3-Clause/), the "License".<br>
+  * You may not use this file except in compliance with the License.
+  *
+  * The keyer sends PARIS at a range of speeds as I/Q TX signal at an IF
+  * offset, so the spectrum is one sided and has room for DDS spurs.
+  * The power spectrum is a Welch average of Blackman-Harris windowed
+  * FFT frames with 50% overlap. All levels are in dB relative to the
+  * carrier bin (dBc). For every speed it reports:
+  *
+  *   rise    10...90% rise time of the TX envelope, ms
+  *   bw-20   occupied bandwidth at -20/-40/-60 dBc within SPEC_SPAN_HZ, Hz
+  *   click   sideband level at 200/500/1000 Hz from the carrier, dBc
+  *   spur    strongest bin beyond SPEC_SPAN_HZ from the carrier, dBc and Hz
+  *
+  * The "key down" row is a steady carrier of the whole TX path.
+  *
+  * With --dds the tool measures the bare DDS instead: softdds_sin () as
+  * a full scale I/Q tone at a set of frequencies from 317 Hz to 23 kHz,
+  * with a 7 term Blackman-Harris window whose sidelobes are far below the
+  * DDS spurs. It reports the worst spur of each tone and fails if one is
+  * above SPEC_DDS_LIMIT, so ctest checks the DDS table and interpolation.
+  * The TX envelope length is built in, the Host CMakeLists.txt makes one
+  * build of the tool per CW_SMOOTH_LEN and the "spectrum" target runs them.
+  *
+  * Usage: selenite_spectrum [--csv <file>] [--seconds <s>] [--offset <Hz>]
+  *        selenite_spectrum --dds
+  *
+  * CSV rows are appended, so the runs of all builds make one table.
+  *
+  *******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "host_stub.h"
+#include "cw_gen.h"
+#include "ptt_if.h"
+#include "dds_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct
+{
+  double rise;          /* ms */
+  double bw [3];        /* Hz at -20, -40, -60 dBc */
+  double click [3];     /* dBc at SPEC_CLICK_HZ offsets */
+  double spur;          /* dBc */
+  double spur_freq;     /* Hz */
+} SPEC_Result_TypeDef;
+
+/* Private define ------------------------------------------------------------*/
+
+#define SPEC_FS             48000.0
+#define SPEC_FFT_BITS       13U
+#define SPEC_FFT_SIZE       (1U << SPEC_FFT_BITS)   /* 5.86 Hz bins */
+#define SPEC_HOP            (SPEC_FFT_SIZE / 2U)
+#define SPEC_BIN_HZ         (SPEC_FS / SPEC_FFT_SIZE)
+
+#define SPEC_SECONDS        30U       /* Audio per speed */
+#define SPEC_IQ_OFFSET      10007     /* Not a bin centre, DDS interpolates */
+#define SPEC_SPAN_HZ        4000.0    /* Keying sidebands, spurs are beyond */
+#define SPEC_CLICK_BINS     4         /* Click level is the peak of +/- 4 bins */
+#define SPEC_RISE_LEN       2048U     /* First element envelope, samples */
+
+#define SPEC_KEY_DOWN       0U        /* Speed of the steady carrier row */
+
+#define SPEC_DDS_FRAMES     8U        /* Frames averaged per DDS tone */
+#define SPEC_DDS_MAIN_BINS  8         /* Main lobe of the 7 term window */
+#define SPEC_DDS_LIMIT      -90.0     /* Worst DDS spur allowed, dBc */
+
+/* Private macro -------------------------------------------------------------*/
+
+#define SPEC_DB(x)          (10.0 * log10 ((x) + 1e-30))
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint8_t spec_speeds [] = { SPEC_KEY_DOWN, 10U, 20U, 30U, 40U, 50U };
+static const double  spec_levels [3] = { 20.0, 40.0, 60.0 };
+static const double  spec_clicks [3] = { 200.0, 500.0, 1000.0 };
+
+/* DDS tones, Hz, not at bin centres */
+static const uint32_t spec_dds_tones [] = { 317U, 1009U, 3001U, 7013U, 10007U, 15013U, 23011U };
+
+static double spec_win   [SPEC_FFT_SIZE];
+static double spec_win7  [SPEC_FFT_SIZE];
+static double spec_cos   [SPEC_FFT_SIZE / 2U];
+static double spec_sin   [SPEC_FFT_SIZE / 2U];
+static double spec_re    [SPEC_FFT_SIZE];
+static double spec_im    [SPEC_FFT_SIZE];
+static double spec_psd   [SPEC_FFT_SIZE];   /* Centred, bin SPEC_FFT_SIZE / 2 is 0 Hz */
+static double spec_env   [SPEC_RISE_LEN];
+
+static int16_t spec_i    [SPEC_FFT_SIZE];
+static int16_t spec_q    [SPEC_FFT_SIZE];
+
+static int16_t block [HOST_BLOCK_SIZE];
+
+/* External variables --------------------------------------------------------*/
+
+extern CW_Keyer cw_keyer;
+extern PTT_TypeDef ptt;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief This function makes the window and the FFT twiddle factors
+ *
+ */
+
+static void spec_init (void)
+{
+  for (uint32_t n = 0U; n < SPEC_FFT_SIZE; n++)
+  {
+    double x = 2.0 * M_PI * n / SPEC_FFT_SIZE;
+
+    /* 4 term Blackman-Harris, -92 dB sidelobes */
+    spec_win [n] = 0.35875 - 0.48829 * cos (x) + 0.14128 * cos (2.0 * x) - 0.01168 * cos (3.0 * x);
+
+    /* 7 term Blackman-Harris, -180 dB sidelobes */
+    spec_win7 [n] = 0.27105140069342 - 0.43329793923448 * cos (x) + 0.21812299954311 * cos (2.0 * x)
+                  - 0.06592544638803 * cos (3.0 * x) + 0.01081174209837 * cos (4.0 * x)
+                  - 0.00077658482522 * cos (5.0 * x) + 0.00001388721735 * cos (6.0 * x);
+  }
+
+  for (uint32_t n = 0U; n < SPEC_FFT_SIZE / 2U; n++)
+  {
+    spec_cos [n] =  cos (2.0 * M_PI * n / SPEC_FFT_SIZE);
+    spec_sin [n] = -sin (2.0 * M_PI * n / SPEC_FFT_SIZE);
+  }
+}
+
+/**
+ * @brief This function is an in-place radix-2 FFT of spec_re, spec_im
+ *
+ */
+
+static void spec_fft (void)
+{
+  for (uint32_t i = 1U, j = 0U; i < SPEC_FFT_SIZE; i++)
+  {
+    uint32_t bit = SPEC_FFT_SIZE >> 1;
+
+    for (; j & bit; bit >>= 1)
+    {
+      j ^= bit;
+    }
+    j ^= bit;
+
+    if (i < j)
+    {
+      double t;
+
+      t = spec_re [i]; spec_re [i] = spec_re [j]; spec_re [j] = t;
+      t = spec_im [i]; spec_im [i] = spec_im [j]; spec_im [j] = t;
+    }
+  }
+
+  for (uint32_t len = 2U; len <= SPEC_FFT_SIZE; len <<= 1)
+  {
+    uint32_t stride = SPEC_FFT_SIZE / len;
+
+    for (uint32_t i = 0U; i < SPEC_FFT_SIZE; i += len)
+    {
+      for (uint32_t k = 0U; k < len / 2U; k++)
+      {
+        double wr = spec_cos [k * stride];
+        double wi = spec_sin [k * stride];
+        uint32_t a = i + k;
+        uint32_t b = a + len / 2U;
+        double tr = spec_re [b] * wr - spec_im [b] * wi;
+        double ti = spec_re [b] * wi + spec_im [b] * wr;
+
+        spec_re [b] = spec_re [a] - tr;
+        spec_im [b] = spec_im [a] - ti;
+        spec_re [a] += tr;
+        spec_im [a] += ti;
+      }
+    }
+  }
+}
+
+/**
+ * @brief This function adds one windowed frame to the power spectrum
+ *
+ * @param Window
+ */
+
+static void spec_frame (const double *win)
+{
+  for (uint32_t n = 0U; n < SPEC_FFT_SIZE; n++)
+  {
+    spec_re [n] = spec_i [n] * win [n];
+    spec_im [n] = spec_q [n] * win [n];
+  }
+
+  spec_fft ();
+
+  for (uint32_t n = 0U; n < SPEC_FFT_SIZE; n++)
+  {
+    spec_psd [(n + SPEC_FFT_SIZE / 2U) & (SPEC_FFT_SIZE - 1U)] += spec_re [n] * spec_re [n] + spec_im [n] * spec_im [n];
+  }
+}
+
+/**
+ * @brief This function runs the keyer and averages the spectrum
+ *
+ * @param Speed, WPM, or SPEC_KEY_DOWN for a steady carrier
+ * @param Audio length, s
+ * @param I/Q TX offset, Hz
+ * @retval 10...90% rise time of the first element, ms
+ */
+
+static double spec_run (uint8_t speed, uint32_t seconds, int32_t offset)
+{
+  static const char text [] = "PARIS ";
+  uint32_t fill = 0U, env_len = 0U;
+  double peak = 0.0, rise = 0.0;
+  int32_t t10 = -1, t90 = -1;
+
+  memset (spec_psd, 0, sizeof (spec_psd));
+
+  HOST_Init ();
+
+  CW_Set_IQ (1U, offset, 0U);
+
+  if (speed == SPEC_KEY_DOWN)
+  {
+    cw_keyer.mode = STRAIGHT;
+    CW_Set_Keyer ();
+
+    ptt.key_dit_is_on = 1U;
+  }
+  else
+  {
+    cw_keyer.speed = speed;
+    CW_Set_Keyer ();
+  }
+
+  for (uint32_t ms = 0U; ms < seconds * 1000U; ms++)
+  {
+    if ((speed != SPEC_KEY_DOWN) && (CW_Text_Free () >= sizeof (text)))
+    {
+      CW_Text_Write (text, sizeof (text) - 1U);
+    }
+
+    HOST_Audio_Block (block);
+
+    for (uint32_t i = 0U; i < HOST_BLOCK_SIZE; i += 2U)
+    {
+      spec_i [fill] = block [i];
+      spec_q [fill] = block [i + 1U];
+
+      /* Envelope of the first element from its first sample */
+      if ((env_len > 0U || block [i] != 0 || block [i + 1U] != 0) && env_len < SPEC_RISE_LEN)
+      {
+        spec_env [env_len++] = hypot (block [i], block [i + 1U]);
+      }
+
+      if (++fill == SPEC_FFT_SIZE)
+      {
+        spec_frame (spec_win);
+
+        memmove (spec_i, spec_i + SPEC_HOP, SPEC_HOP * sizeof (spec_i [0]));
+        memmove (spec_q, spec_q + SPEC_HOP, SPEC_HOP * sizeof (spec_q [0]));
+        fill = SPEC_FFT_SIZE - SPEC_HOP;
+      }
+    }
+  }
+
+  for (uint32_t n = 0U; n < env_len; n++)
+  {
+    peak = fmax (peak, spec_env [n]);
+  }
+
+  for (uint32_t n = 0U; n < env_len; n++)
+  {
+    if (t10 < 0 && spec_env [n] >= 0.1 * peak)
+    {
+      t10 = n;
+    }
+
+    if (t90 < 0 && spec_env [n] >= 0.9 * peak)
+    {
+      t90 = n;
+      break;
+    }
+  }
+
+  if (t10 >= 0 && t90 >= 0)
+  {
+    rise = (t90 - t10) * 1000.0 / SPEC_FS;
+  }
+
+  return rise;
+}
+
+/**
+ * @brief This function measures the averaged spectrum
+ *
+ * @param I/Q TX offset, Hz
+ * @param Result
+ */
+
+static void spec_measure (int32_t offset, SPEC_Result_TypeDef *result)
+{
+  int32_t centre = SPEC_FFT_SIZE / 2U;
+  int32_t span   = (int32_t) (SPEC_SPAN_HZ / SPEC_BIN_HZ);
+  int32_t c      = centre + (int32_t) lround (offset / SPEC_BIN_HZ);
+  double  ref;
+
+  /* The carrier is the peak near the offset */
+  for (int32_t n = c - SPEC_CLICK_BINS; n <= c + SPEC_CLICK_BINS; n++)
+  {
+    if (spec_psd [n] > spec_psd [c])
+    {
+      c = n;
+    }
+  }
+
+  ref = spec_psd [c];
+
+  /* Occupied bandwidth is between the outermost bins above the level */
+  for (uint32_t l = 0U; l < 3U; l++)
+  {
+    double  thr = ref * pow (10.0, -spec_levels [l] / 10.0);
+    int32_t lo = c, hi = c;
+
+    for (int32_t n = c - span; n <= c + span; n++)
+    {
+      if (n < 0 || n >= (int32_t) SPEC_FFT_SIZE || spec_psd [n] < thr)
+      {
+        continue;
+      }
+
+      if (n < lo)
+      {
+        lo = n;
+      }
+
+      if (n > hi)
+      {
+        hi = n;
+      }
+    }
+
+    result->bw [l] = (hi - lo + 1) * SPEC_BIN_HZ;
+  }
+
+  /* Key clicks, the louder of both sides */
+  for (uint32_t l = 0U; l < 3U; l++)
+  {
+    int32_t d   = (int32_t) lround (spec_clicks [l] / SPEC_BIN_HZ);
+    double  max = 0.0;
+
+    for (int32_t n = -SPEC_CLICK_BINS; n <= SPEC_CLICK_BINS; n++)
+    {
+      max = fmax (max, spec_psd [c - d + n]);
+      max = fmax (max, spec_psd [c + d + n]);
+    }
+
+    result->click [l] = SPEC_DB (max / ref);
+  }
+
+  /* Spurs are anywhere beyond the keying sidebands */
+  result->spur      = -400.0;
+  result->spur_freq = 0.0;
+
+  for (int32_t n = 0; n < (int32_t) SPEC_FFT_SIZE; n++)
+  {
+    double level;
+
+    if (abs (n - c) <= span)
+    {
+      continue;
+    }
+
+    level = SPEC_DB (spec_psd [n] / ref);
+
+    if (level > result->spur)
+    {
+      result->spur      = level;
+      result->spur_freq = (n - centre) * SPEC_BIN_HZ;
+    }
+  }
+}
+
+/**
+ * @brief This function measures the worst spur of the bare DDS
+ *
+ * @param Tone, Hz
+ * @param Frequency of the spur, Hz
+ * @retval Spur level, dBc
+ */
+
+static double spec_dds (uint32_t freq, double *spur_freq)
+{
+  uint32_t step   = softdds_getStep (freq, (uint32_t) SPEC_FS);
+  uint32_t phase  = 0U;
+  int32_t  centre = SPEC_FFT_SIZE / 2U;
+  int32_t  c      = centre + (int32_t) lround (freq / SPEC_BIN_HZ);
+  double   spur   = -400.0;
+
+  memset (spec_psd, 0, sizeof (spec_psd));
+
+  for (uint32_t f = 0U; f < SPEC_DDS_FRAMES; f++)
+  {
+    for (uint32_t n = 0U; n < SPEC_FFT_SIZE; n++)
+    {
+      spec_i [n] = softdds_sin (phase + 0x40000000U);
+      spec_q [n] = softdds_sin (phase);
+      phase += step;
+    }
+
+    spec_frame (spec_win7);
+  }
+
+  for (int32_t n = c - SPEC_DDS_MAIN_BINS; n <= c + SPEC_DDS_MAIN_BINS; n++)
+  {
+    if (spec_psd [n] > spec_psd [c])
+    {
+      c = n;
+    }
+  }
+
+  for (int32_t n = 0; n < (int32_t) SPEC_FFT_SIZE; n++)
+  {
+    double level;
+
+    if (abs (n - c) <= SPEC_DDS_MAIN_BINS)
+    {
+      continue;
+    }
+
+    level = SPEC_DB (spec_psd [n] / spec_psd [c]);
+
+    if (level > spur)
+    {
+      spur       = level;
+      *spur_freq = (n - centre) * SPEC_BIN_HZ;
+    }
+  }
+
+  return spur;
+}
+
+/**
+ * @brief This function reports the DDS spurs of all test tones
+ *
+ * @retval EXIT_SUCCESS if all spurs are below SPEC_DDS_LIMIT
+ */
+
+static int spec_dds_run (void)
+{
+  double worst = -400.0;
+
+  printf ("DDS %u points per quarter, full scale I/Q, %u frames of %u points\n\n",
+          (unsigned int) DDS_TBL_SIZE, SPEC_DDS_FRAMES, SPEC_FFT_SIZE);
+  printf ("   tone Hz    spur dBc   at Hz\n");
+
+  for (uint32_t t = 0U; t < sizeof (spec_dds_tones) / sizeof (spec_dds_tones [0]); t++)
+  {
+    double spur_freq = 0.0;
+    double spur      = spec_dds (spec_dds_tones [t], &spur_freq);
+
+    printf ("%10u %11.1f %7.0f\n", (unsigned int) spec_dds_tones [t], spur, spur_freq);
+
+    worst = fmax (worst, spur);
+  }
+
+  printf ("\nWorst spur %.1f dBc, limit %.1f dBc\n", worst, SPEC_DDS_LIMIT);
+
+  return (worst <= SPEC_DDS_LIMIT) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief The application entry point
+ *
+ */
+
+int main (int argc, char *argv [])
+{
+  const char *csv_name = NULL;
+  uint32_t seconds = SPEC_SECONDS;
+  int32_t  offset  = SPEC_IQ_OFFSET;
+  FILE *csv = NULL;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp (argv [i], "--csv") && i + 1 < argc)
+    {
+      csv_name = argv [++i];
+    }
+    else if (!strcmp (argv [i], "--seconds") && i + 1 < argc)
+    {
+      seconds = (uint32_t) atoi (argv [++i]);
+    }
+    else if (!strcmp (argv [i], "--offset") && i + 1 < argc)
+    {
+      offset = atoi (argv [++i]);
+    }
+    else if (!strcmp (argv [i], "--dds"))
+    {
+      spec_init ();
+      return spec_dds_run ();
+    }
+    else
+    {
+      fprintf (stderr, "Usage: %s [--csv <file>] [--seconds <s>] [--offset <Hz>] | --dds\n", argv [0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (seconds < 1U || offset + SPEC_SPAN_HZ >= SPEC_FS / 2.0 || offset - SPEC_SPAN_HZ <= -SPEC_FS / 2.0)
+  {
+    fprintf (stderr, "Audio length or offset is out of range\n");
+    return EXIT_FAILURE;
+  }
+
+  if (csv_name != NULL)
+  {
+    csv = fopen (csv_name, "a");
+
+    if (csv == NULL)
+    {
+      perror (csv_name);
+      return EXIT_FAILURE;
+    }
+
+    if (ftell (csv) == 0)
+    {
+      fprintf (csv, "rise_ms,wpm,bw20_hz,bw40_hz,bw60_hz,click200_dbc,click500_dbc,click1k_dbc,spur_dbc,spur_hz\n");
+    }
+  }
+
+  spec_init ();
+
+  printf ("Offset %d Hz, %u s per speed, %.2f Hz bins\n\n", offset, seconds, SPEC_BIN_HZ);
+  printf (" rise    wpm   bw-20   bw-40   bw-60   click200 click500 click1k    spur  at Hz\n");
+
+  for (uint32_t s = 0U; s < sizeof (spec_speeds); s++)
+  {
+    SPEC_Result_TypeDef result;
+    double rise = spec_run (spec_speeds [s], seconds, offset);
+
+    spec_measure (offset, &result);
+    result.rise = rise;
+
+    if (spec_speeds [s] == SPEC_KEY_DOWN)
+    {
+      printf ("%5.2f    key down                           %8.1f %8.1f %8.1f %7.1f %7.0f\n",
+              result.rise, result.click [0], result.click [1], result.click [2],
+              result.spur, result.spur_freq);
+    }
+    else
+    {
+      printf ("%5.2f %6u %7.0f %7.0f %7.0f %8.1f %8.1f %8.1f %7.1f %7.0f\n",
+              result.rise, spec_speeds [s], result.bw [0], result.bw [1], result.bw [2],
+              result.click [0], result.click [1], result.click [2],
+              result.spur, result.spur_freq);
+    }
+
+    if (csv != NULL)
+    {
+      fprintf (csv, "%.3f,%u,%.1f,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,%.1f\n",
+               result.rise, spec_speeds [s], result.bw [0], result.bw [1], result.bw [2],
+               result.click [0], result.click [1], result.click [2],
+               result.spur, result.spur_freq);
+    }
+  }
+
+  if (csv != NULL)
+  {
+    fclose (csv);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/****END OF FILE****/
@@ -24,7 +24,8 @@
 
 /* USER CODE BEGIN INCLUDE */
 #include "ptt_if.h"
-#include "usbd_comp.h"
+#include "cat_if.h"
+#include "sched_if.h"
 
 /* USER CODE END INCLUDE */
 
@@ -53,6 +54,14 @@
 
 /* USER CODE BEGIN PRIVATE_TYPES */
 
+typedef struct
+{
+  uint8_t           buff [CDC_TX_RING_SIZE];
+  __IO uint32_t     wr_ptr;        /* Free running write index */
+  __IO uint32_t     rd_ptr;        /* Free running read index */
+  uint32_t          last_len;      /* Length of the last packet sent */
+} CDC_TX_Ring_TypeDef;
+
 /* USER CODE END PRIVATE_TYPES */
 
 /**
@@ -69,6 +78,8 @@
 /* It's up to user to redefine and/or remove those define */
 #define APP_RX_DATA_SIZE  64
 #define APP_TX_DATA_SIZE  64
+
+#define CDC_TX_PACKET_SIZE  CDC_DATA_FS_MAX_PACKET_SIZE
 /* USER CODE END PRIVATE_DEFINES */
 
 /**
@@ -102,6 +113,11 @@ uint8_t UserTxBufferFS[APP_TX_DATA_SIZE];
 
 /* USER CODE BEGIN PRIVATE_VARIABLES */
 
+static CDC_TX_Ring_TypeDef cdc_tx;
+
+/* OUT endpoint is not re-armed until the CAT buffer has room for a packet */
+static __IO uint8_t cdc_rx_paused;
+
 /* USER CODE END PRIVATE_VARIABLES */
 
 /**
@@ -117,6 +133,8 @@ extern USBD_HandleTypeDef hUsbDeviceFS;
 
 /* USER CODE BEGIN EXPORTED_VARIABLES */
 
+CDC_Stats_TypeDef cdc_stats;
+
 /* USER CODE END EXPORTED_VARIABLES */
 
 /**
@@ -136,6 +154,9 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
 
+static void cdc_tx_start (uint8_t partial);
+static uint16_t cdc_tx_write (const uint8_t *Buf, uint16_t Len, uint8_t whole);
+
 /* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
 
 /**
@@ -162,6 +183,13 @@ static int8_t CDC_Init_FS(void)
   /* Set Application Buffers */
   USBD_CDC_SetTxBuffer(&hUsbDeviceFS, UserTxBufferFS, 0);
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserRxBufferFS);
+
+  cdc_tx.wr_ptr   = 0U;
+  cdc_tx.rd_ptr   = 0U;
+  cdc_tx.last_len = 0U;
+
+  cdc_rx_paused = 0U;
+
   return (USBD_OK);
   /* USER CODE END 3 */
 }
@@ -278,15 +306,27 @@ static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 6 */
-  CDC_Transmit_FS (Buf, *Len); //++++++
+  for (uint32_t i = 0; i < *Len; i++)
+  {
+    CAT_Buff_Write_Byte (Buf[i]);  // CAT_Buff_Write_Byte() is declared in cat_if.c
+  }
 
-  //for (uint32_t i = 0; i < *Len; i++)
-  //{
-  //  CAT_Buff_Write_Byte (Buf[i]);  // CAT_Buff_Write_Byte() is declared in cat_if.c
-  //}
+  cdc_stats.rx_bytes += *Len;
+
+  SCHED_Post (SCHED_CAT);
 
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, &Buf[0]);
-  USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+
+  /* Back-pressure: the host is NAKed until the main loop frees the buffer */
+  if (CAT_Buff_Free () < CDC_DATA_FS_OUT_PACKET_SIZE)
+  {
+    cdc_rx_paused = 1U;
+    cdc_stats.rx_stalls++;
+  }
+  else
+  {
+    USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+  }
 
   return (USBD_OK);
   /* USER CODE END 6 */
@@ -307,17 +347,12 @@ uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len)
 {
   uint8_t result = USBD_OK;
   /* USER CODE BEGIN 7 */
-  result = COMP_CDC_Transmit_FS (Buf, Len); //++++++
 
-  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
-
-  if (hcdc->TxState != 0)
+  /* The whole buffer is queued or nothing at all */
+  if (cdc_tx_write (Buf, Len, 1U) != Len)
   {
-    return USBD_BUSY;
+    result = USBD_BUSY;
   }
-
-  USBD_CDC_SetTxBuffer(&hUsbDeviceFS, Buf, Len);
-  result = USBD_CDC_TransmitPacket(&hUsbDeviceFS);
   /* USER CODE END 7 */
   return result;
 }
@@ -341,12 +376,171 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
   UNUSED(Buf);
   UNUSED(Len);
   UNUSED(epnum);
+
+  /* Chain the next packet (or the terminating ZLP) from the TX ring */
+  cdc_tx_start (1U);
   /* USER CODE END 13 */
   return result;
 }
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
+/**
+  * @brief  cdc_tx_start
+  *         Starts transmission of the next packet from the TX ring
+  *
+  *         @note
+  *         Must be called from the USB interrupt or with interrupts disabled.
+  *         Packets are sent straight with USBD_LL_Transmit(), so the CDC class
+  *         does not append a ZLP to every full packet: a ZLP is sent only when
+  *         the ring runs empty right after a full packet.
+  *
+  * @param  partial: 1 - send a short packet too, 0 - wait for a full packet
+  * @retval None
+  */
+static __HOT_FUNC void cdc_tx_start (uint8_t partial)
+{
+  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*) hUsbDeviceFS.pClassData;
+  uint32_t pending;
+  uint32_t len;
+
+  if ((hcdc == NULL) || (hcdc->TxState != 0U)) return;
+
+  pending = cdc_tx.wr_ptr - cdc_tx.rd_ptr;
+
+  if (pending == 0U)
+  {
+    if (cdc_tx.last_len == CDC_TX_PACKET_SIZE)
+    {
+      /* Terminate the bulk transfer with a zero-length packet */
+      cdc_tx.last_len = 0U;
+      hcdc->TxState   = 1U;
+      cdc_stats.tx_zlp++;
+
+      USBD_LL_Transmit (&hUsbDeviceFS, CDC_IN_EP, NULL, 0U);
+    }
+    return;
+  }
+
+  if ((pending < CDC_TX_PACKET_SIZE) && !partial) return;
+
+  len = (pending < CDC_TX_PACKET_SIZE) ? pending : CDC_TX_PACKET_SIZE;
+
+  for (uint32_t i = 0U; i < len; i++)
+  {
+    UserTxBufferFS [i] = cdc_tx.buff [(cdc_tx.rd_ptr + i) & (CDC_TX_RING_SIZE - 1U)];
+  }
+
+  cdc_tx.rd_ptr  += len;
+  cdc_tx.last_len = len;
+
+  hcdc->TxBuffer = UserTxBufferFS;
+  hcdc->TxLength = len;
+  hcdc->TxState  = 1U;
+
+  cdc_stats.tx_bytes += len;
+  cdc_stats.tx_packets++;
+
+  USBD_LL_Transmit (&hUsbDeviceFS, CDC_IN_EP, UserTxBufferFS, len);
+}
+
+/**
+  * @brief  cdc_tx_write
+  *         Copies data into the TX ring
+  *
+  *         @note
+  *         The free space check, the copy and the statistics are done with
+  *         interrupts disabled, so a write from an interrupt handler can not
+  *         take the space in between.
+  *
+  * @param  Buf: Buffer of data to be sent
+  * @param  Len: Number of data to be sent (in bytes)
+  * @param  whole: 1 - queue all the data or nothing, 0 - queue what fits
+  * @retval Number of bytes queued
+  */
+static __HOT_FUNC uint16_t cdc_tx_write (const uint8_t *Buf, uint16_t Len, uint8_t whole)
+{
+  uint32_t primask = __get_PRIMASK ();
+  uint32_t space;
+
+  __disable_irq ();
+
+  space = CDC_TX_RING_SIZE - (cdc_tx.wr_ptr - cdc_tx.rd_ptr);
+
+  if (Len > space)
+  {
+    cdc_stats.tx_overflows++;
+
+    if (whole)
+    {
+      __set_PRIMASK (primask);
+      return 0U;
+    }
+
+    cdc_stats.tx_dropped += Len - space;
+    Len = space;
+  }
+
+  for (uint16_t i = 0U; i < Len; i++)
+  {
+    cdc_tx.buff [(cdc_tx.wr_ptr + i) & (CDC_TX_RING_SIZE - 1U)] = Buf [i];
+  }
+
+  cdc_tx.wr_ptr += Len;
+
+  cdc_tx_start (__get_IPSR () == 0U);
+
+  __set_PRIMASK (primask);
+
+  return Len;
+}
+
+/**
+  * @brief  CDC_Write_FS
+  *         Queues data for transmission over the CDC interface
+  *
+  *         @note
+  *         Never blocks. Data which does not fit into the TX ring is dropped
+  *         and counted in cdc_stats. When called from an interrupt handler the
+  *         data is coalesced into full packets, the rest is sent by
+  *         the next transfer complete event or by CDC_Handler_FS().
+  *
+  * @param  Buf: Buffer of data to be sent
+  * @param  Len: Number of data to be sent (in bytes)
+  * @retval Number of bytes queued
+  */
+__HOT_FUNC uint16_t CDC_Write_FS (const uint8_t *Buf, uint16_t Len)
+{
+  return cdc_tx_write (Buf, Len, 0U);
+}
+
+/**
+  * @brief  CDC_Handler_FS
+  *         Sends the data left in the TX ring by interrupt handlers
+  *
+  *         @note
+  *         Called from the main loop. Also re-arms reception which was
+  *         deferred by CDC_Receive_FS() once the CAT buffer has room.
+  *
+  * @retval None
+  */
+void CDC_Handler_FS (void)
+{
+  uint32_t primask = __get_PRIMASK ();
+
+  __disable_irq ();
+
+  cdc_tx_start (1U);
+
+  if (cdc_rx_paused && (CAT_Buff_Free () >= CDC_DATA_FS_OUT_PACKET_SIZE))
+  {
+    cdc_rx_paused = 0U;
+    USBD_CDC_ReceivePacket (&hUsbDeviceFS);
+  }
+
+  __set_PRIMASK (primask);
+}
+
 /* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
 /**
@@ -53,6 +53,9 @@
 #define APP_TX_DATA_SIZE  64
 /* USER CODE BEGIN EXPORTED_DEFINES */
 
+/* TX ring size in bytes, must be a power of 2 */
+#define CDC_TX_RING_SIZE  1024U
+
 /* USER CODE END EXPORTED_DEFINES */
 
 /**
@@ -66,6 +69,17 @@
 
 /* USER CODE BEGIN EXPORTED_TYPES */
 
+typedef struct
+{
+  uint32_t tx_bytes;      /* Bytes sent to the host */
+  uint32_t tx_packets;    /* Data packets sent to the host */
+  uint32_t tx_zlp;        /* Zero-length packets sent */
+  uint32_t tx_overflows;  /* Writes which did not fit into the TX ring */
+  uint32_t tx_dropped;    /* Bytes dropped because of TX ring overflow */
+  uint32_t rx_bytes;      /* Bytes received from the host */
+  uint32_t rx_stalls;     /* Times reception was paused by back-pressure */
+} CDC_Stats_TypeDef;
+
 /* USER CODE END EXPORTED_TYPES */
 
 /**
@@ -95,6 +109,8 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_FS;
 
 /* USER CODE BEGIN EXPORTED_VARIABLES */
 
+extern CDC_Stats_TypeDef cdc_stats;
+
 /* USER CODE END EXPORTED_VARIABLES */
 
 /**
@@ -110,6 +126,9 @@ uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
 
+uint16_t CDC_Write_FS (const uint8_t *Buf, uint16_t Len);
+void CDC_Handler_FS (void);
+
 /* USER CODE END EXPORTED_FUNCTIONS */
 
 /**